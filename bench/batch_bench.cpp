@@ -0,0 +1,63 @@
+// 对比逐条调用和用 Batch 一次执行 Get、IncrBy、PExpire 三条命令的耗时。
+#include <chrono>
+#include <cstdio>
+#include <libcache/libcache.hpp>
+#include <string>
+
+namespace libcache {
+
+static constexpr size_t kKeyCount = 100000;
+static constexpr size_t kOps = 1000000;
+static constexpr size_t kRounds = 3;
+
+template <typename Fn>
+static double NanosPerOp(Fn fn) {
+  double best = 0;
+  for (size_t round = 0; round < kRounds; round++) {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kOps; i++) {
+      fn(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    if (round == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best / kOps;
+}
+
+}  // namespace libcache
+
+int main() {
+  using namespace libcache;
+
+  auto cache = Cache::New();
+  for (size_t i = 0; i < kKeyCount; i++) {
+    cache->Set("key:" + std::to_string(i), "0");
+  }
+
+  auto calls = NanosPerOp([&](size_t i) {
+    auto key = "key:" + std::to_string(i % kKeyCount);
+    cache->Get(key);
+    cache->IncrBy(key, 1);
+    cache->PExpire(key, 3600 * 1000);
+  });
+  auto batch = NanosPerOp([&](size_t i) {
+    auto key = "key:" + std::to_string(i % kKeyCount);
+    Batch batch;
+    batch.Get(key).IncrBy(key, 1).PExpire(key, 3600 * 1000);
+    cache->Exec(batch);
+  });
+  auto watched = NanosPerOp([&](size_t i) {
+    auto key = "key:" + std::to_string(i % kKeyCount);
+    Batch batch;
+    cache->Watch(batch, {key});
+    batch.Get(key).IncrBy(key, 1).PExpire(key, 3600 * 1000);
+    cache->Exec(batch);
+  });
+  printf("3 calls: %6.1f ns, batch: %6.1f ns, watch + batch: %6.1f ns\n",
+         calls, batch, watched);
+  delete cache;
+  return 0;
+}
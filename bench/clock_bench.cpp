@@ -0,0 +1,79 @@
+// 对比 DBOptions::access_clock 取 kPrecise 和 kCoarse 时每次操作的耗时。
+#include <time.h>
+
+#include <chrono>
+#include <cstdio>
+#include <libcache/libcache.hpp>
+#include <string>
+
+namespace libcache {
+
+static constexpr size_t kKeyCount = 100000;
+static constexpr size_t kOps = 1000000;
+static constexpr size_t kRounds = 5;
+
+// 取多轮中最快的一轮，减少噪声。
+template <typename Fn>
+static double NanosPerOp(size_t ops, Fn fn) {
+  double best = 0;
+  for (size_t round = 0; round < kRounds; round++) {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; i++) {
+      fn(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    if (round == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best / ops;
+}
+
+static void BenchCache(ClockMode mode, const char* name) {
+  Options options;
+  options.db_options_array[0].access_clock = mode;
+  auto cache = Cache::New(options);
+
+  char key[32];
+  for (size_t i = 0; i < kKeyCount; i++) {
+    snprintf(key, sizeof(key), "key:%zu", i);
+    cache->Set(key, "value");
+  }
+
+  auto get = NanosPerOp(kOps, [&](size_t i) {
+    auto size = snprintf(key, sizeof(key), "key:%zu", i % kKeyCount);
+    cache->Get(std::string_view(key, size));
+  });
+  auto set = NanosPerOp(kOps, [&](size_t i) {
+    auto size = snprintf(key, sizeof(key), "ttl:%zu", i % kKeyCount);
+    cache->Set(std::string_view(key, size), "value", 0, PX(3600 * 1000));
+  });
+  printf("%-8s get: %6.1f ns/op, set with expire: %6.1f ns/op\n", name, get,
+         set);
+  delete cache;
+}
+
+}  // namespace libcache
+
+int main() {
+  using namespace libcache;
+
+  volatile int64_t sink = 0;
+  auto steady = NanosPerOp(kOps, [&](size_t) {
+    sink = std::chrono::steady_clock::now().time_since_epoch().count();
+  });
+  printf("steady_clock::now: %.1f ns\n", steady);
+#ifdef CLOCK_MONOTONIC_COARSE
+  auto coarse = NanosPerOp(kOps, [&](size_t) {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    sink = ts.tv_nsec;
+  });
+  printf("CLOCK_MONOTONIC_COARSE: %.1f ns\n", coarse);
+#endif
+
+  BenchCache(ClockMode::kPrecise, "precise");
+  BenchCache(ClockMode::kCoarse, "coarse");
+  return 0;
+}
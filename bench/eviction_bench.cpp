@@ -0,0 +1,164 @@
+// 在同一条访问轨迹上对比近似 LRU、LFU 淘汰、TinyLFU 准入和精确 LRU 的命中率。
+// 每次访问先 Get，未命中时 Set；精确 LRU 的容量取 libcache 写满后保存的键数。
+// 轨迹文件每行一个键，由第一个参数指定，没有参数时生成 Zipf 分布的轨迹，以及
+// 在其中周期性插入一段只访问一次的键的扫描轨迹。
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <libcache/libcache.hpp>
+#include <list>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace libcache {
+
+static constexpr size_t kKeyCount = 100000;
+static constexpr size_t kAccesses = 2000000;
+static constexpr double kZipfSkew = 0.99;
+static constexpr size_t kMaxMemory = 4 * 1024 * 1024;
+static constexpr size_t kValueSize = 100;
+// 每隔 kScanInterval 次访问插入 kScanLength 个只访问一次的键。
+static constexpr size_t kScanInterval = 20000;
+static constexpr size_t kScanLength = 5000;
+
+static std::vector<std::string> ZipfTrace() {
+  std::vector<double> cdf(kKeyCount);
+  double sum = 0;
+  for (size_t i = 0; i < kKeyCount; i++) {
+    sum += 1 / std::pow(i + 1, kZipfSkew);
+    cdf[i] = sum;
+  }
+
+  std::mt19937_64 rng(1);
+  std::uniform_real_distribution<double> dist(0, sum);
+  std::vector<std::string> trace;
+  trace.reserve(kAccesses);
+  for (size_t i = 0; i < kAccesses; i++) {
+    auto rank = std::lower_bound(cdf.begin(), cdf.end(), dist(rng)) -
+                cdf.begin();
+    trace.push_back("key:" + std::to_string(rank));
+  }
+  return trace;
+}
+
+static std::vector<std::string> ScanTrace(
+    const std::vector<std::string>& zipf) {
+  std::vector<std::string> trace;
+  trace.reserve(zipf.size() + zipf.size() / kScanInterval * kScanLength);
+  size_t scanned = 0;
+  for (size_t i = 0; i < zipf.size(); i++) {
+    if (i % kScanInterval == kScanInterval - 1) {
+      for (size_t j = 0; j < kScanLength; j++) {
+        trace.push_back("scan:" + std::to_string(scanned++));
+      }
+    }
+    trace.push_back(zipf[i]);
+  }
+  return trace;
+}
+
+static std::vector<std::string> ReadTrace(const char* path) {
+  std::vector<std::string> trace;
+  std::ifstream file(path);
+  std::string key;
+  while (std::getline(file, key)) {
+    trace.push_back(key);
+  }
+  return trace;
+}
+
+struct Result {
+  double hit_ratio;
+  // 结束时缓存中的键数。
+  size_t keys;
+};
+
+static Result RunCache(const std::vector<std::string>& trace,
+                       EvictionPolicy policy, size_t samples,
+                       bool admission_filter) {
+  Options options;
+  auto& db_options = options.db_options_array[0];
+  db_options.maxmemory = kMaxMemory;
+  db_options.eviction_policy = policy;
+  db_options.eviction_samples = samples;
+  db_options.admission_filter = admission_filter;
+  db_options.access_clock = ClockMode::kPrecise;
+  auto cache = Cache::New(options);
+
+  const std::string value(kValueSize, 'v');
+  size_t hits = 0;
+  for (const auto& key : trace) {
+    if (cache->Get(key)) {
+      hits++;
+    } else {
+      cache->Set(key, value);
+    }
+  }
+  auto evicted = cache->MemoryStats().evicted_keys;
+  delete cache;
+  return {static_cast<double>(hits) / trace.size(),
+          trace.size() - hits - evicted};
+}
+
+static double RunExactLRU(const std::vector<std::string>& trace,
+                          size_t capacity) {
+  std::list<std::string_view> order;
+  std::unordered_map<std::string_view, std::list<std::string_view>::iterator>
+      index;
+  size_t hits = 0;
+  for (const auto& key : trace) {
+    auto it = index.find(key);
+    if (it != index.end()) {
+      hits++;
+      order.splice(order.begin(), order, it->second);
+      continue;
+    }
+    if (index.size() == capacity) {
+      index.erase(order.back());
+      order.pop_back();
+    }
+    order.push_front(key);
+    index[key] = order.begin();
+  }
+  return static_cast<double>(hits) / trace.size();
+}
+
+static void RunTrace(const char* name, const std::vector<std::string>& trace) {
+  printf("%s: accesses %zu, maxmemory %zu, value size %zu\n", name,
+         trace.size(), kMaxMemory, kValueSize);
+  auto print = [&](const char* policy, size_t samples, const Result& result) {
+    printf("  %-20s samples=%-2zu hit ratio %.4f, exact lru %.4f "
+           "(%zu keys)\n",
+           policy, samples, result.hit_ratio, RunExactLRU(trace, result.keys),
+           result.keys);
+  };
+  for (size_t samples : {3, 5, 10}) {
+    print("allkeys-lru", samples,
+          RunCache(trace, EvictionPolicy::kAllKeysLRU, samples, false));
+  }
+  print("allkeys-lfu", 5,
+        RunCache(trace, EvictionPolicy::kAllKeysLFU, 5, false));
+  print("allkeys-lru tinylfu", 5,
+        RunCache(trace, EvictionPolicy::kAllKeysLRU, 5, true));
+  print("allkeys-lfu tinylfu", 5,
+        RunCache(trace, EvictionPolicy::kAllKeysLFU, 5, true));
+}
+
+}  // namespace libcache
+
+int main(int argc, char* argv[]) {
+  using namespace libcache;
+
+  if (argc > 1) {
+    RunTrace(argv[1], ReadTrace(argv[1]));
+    return 0;
+  }
+  auto zipf = ZipfTrace();
+  RunTrace("zipf", zipf);
+  RunTrace("zipf + scan", ScanTrace(zipf));
+  return 0;
+}
@@ -0,0 +1,58 @@
+// 大量键同时到期时，主动过期对其他命令延迟的影响。
+#include <chrono>
+#include <cstdio>
+#include <libcache/libcache.hpp>
+#include <string>
+
+namespace libcache {
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t kKeyCount = 1000000;
+
+static void BenchExpire(size_t budget_us, size_t max_percent) {
+  Options options;
+  options.timer_interval = 100;
+  options.db_options_array[0].expire_cycle_budget_us = budget_us;
+  options.db_options_array[0].expire_cycle_max_percent = max_percent;
+  auto cache = Cache::New(options);
+
+  char key[32];
+  for (size_t i = 0; i < kKeyCount; i++) {
+    snprintf(key, sizeof(key), "key:%zu", i);
+    cache->Set(key, "value", 0, PX(1));
+  }
+  cache->Set("hot", "value");
+
+  // 所有键到期后，不断读取一个不过期的键，记录最慢的一次。
+  auto begin = Clock::now();
+  double max_us = 0;
+  size_t ops = 0;
+  while (cache->ExpireStats().expired_keys < kKeyCount) {
+    auto op_begin = Clock::now();
+    cache->Get("hot");
+    std::chrono::duration<double, std::micro> elapsed =
+        Clock::now() - op_begin;
+    if (elapsed.count() > max_us) {
+      max_us = elapsed.count();
+    }
+    ops++;
+  }
+  std::chrono::duration<double, std::milli> total = Clock::now() - begin;
+  auto stats = cache->ExpireStats();
+  printf(
+      "budget %6zu us, max %3zu%%: %zu keys expired in %.0f ms, %zu cycles, "
+      "%zu gets, max get latency %.0f us\n",
+      budget_us, max_percent, stats.expired_keys, total.count(), stats.cycles,
+      ops, max_us);
+  delete cache;
+}
+
+}  // namespace libcache
+
+int main() {
+  libcache::BenchExpire(1000, 25);
+  // 预算足够一次处理完，相当于不限制预算。
+  libcache::BenchExpire(100000000, 100);
+  return 0;
+}
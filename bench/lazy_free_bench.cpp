@@ -0,0 +1,53 @@
+// 对比同步释放和后台释放时，FlushDB 和覆盖大值的 Set 在调用线程上的耗时。
+#include <chrono>
+#include <cstdio>
+#include <libcache/libcache.hpp>
+#include <string>
+
+namespace libcache {
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t kKeyCount = 1000000;
+static constexpr size_t kBigValueSize = 256 * 1024 * 1024;
+
+template <typename Fn>
+static double Millis(Fn fn) {
+  auto begin = Clock::now();
+  fn();
+  std::chrono::duration<double, std::milli> elapsed = Clock::now() - begin;
+  return elapsed.count();
+}
+
+static void BenchFlush(FlushMode mode, const char* name) {
+  auto cache = Cache::New();
+  char key[32];
+  for (size_t i = 0; i < kKeyCount; i++) {
+    snprintf(key, sizeof(key), "key:%zu", i);
+    cache->Set(key, std::string(100, 'a'));
+  }
+  printf("flushdb %-5s %zu keys: %.1f ms\n", name, kKeyCount,
+         Millis([&]() { cache->FlushDB(mode); }));
+  delete cache;
+}
+
+static void BenchOverwrite(size_t threshold) {
+  Options options;
+  options.db_options_array[0].lazy_free_threshold = threshold;
+  auto cache = Cache::New(options);
+  // 先写满内存页，避免释放时只是归还未使用的页。
+  cache->Set("big", std::string(kBigValueSize, 'a'));
+  printf("overwrite 256MB value, lazy_free_threshold %zu: %.2f ms\n",
+         threshold, Millis([&]() { cache->Set("big", "small"); }));
+  delete cache;
+}
+
+}  // namespace libcache
+
+int main() {
+  libcache::BenchFlush(libcache::FlushMode::kSync, "sync");
+  libcache::BenchFlush(libcache::FlushMode::kAsync, "async");
+  libcache::BenchOverwrite(0);
+  libcache::BenchOverwrite(64 * 1024);
+  return 0;
+}
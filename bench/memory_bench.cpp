@@ -0,0 +1,63 @@
+// 统计每个键占用的内存：glibc mallinfo2 统计的堆内存加上已切出的 slab，
+// 和 MemoryStats::used_memory 记账的结果对比。
+#include <malloc.h>
+
+#include <cstdio>
+#include <libcache/libcache.hpp>
+#include <string>
+
+namespace libcache {
+
+static constexpr size_t kSlabSize = 64 * 1024;
+
+// 大块内存由 glibc 直接 mmap，不计入 uordblks，需要加上 hblkhd。
+static size_t HeapBytes() {
+  auto info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+// accounted 返回按 used_memory 计算的每个键的字节数。
+static double BytesPerKey(size_t key_count, const std::string& value,
+                          const Expiration& expiration, double& accounted) {
+  auto before = HeapBytes();
+  auto cache = Cache::New();
+
+  char key[32];
+  for (size_t i = 0; i < key_count; i++) {
+    snprintf(key, sizeof(key), "key:%012zu", i);
+    cache->Set(key, value, 0, expiration);
+  }
+
+  auto after = HeapBytes();
+  auto stats = cache->MemoryStats();
+  auto slabs = stats.slabs;
+  accounted = static_cast<double>(stats.used_memory) / key_count;
+  delete cache;
+  return static_cast<double>(after - before + slabs * kSlabSize) / key_count;
+}
+
+}  // namespace libcache
+
+int main() {
+  using libcache::BytesPerKey;
+
+  constexpr size_t kKeyCount = 1000000;
+  const std::string value = "0123456789";
+
+  printf("keys: %zu, key size: 16, value size: %zu\n", kKeyCount,
+         value.size());
+  double accounted = 0;
+  auto measured = BytesPerKey(kKeyCount, value, NO_EXPIRE, accounted);
+  printf("no expire: %.1f bytes/key, accounted %.1f\n", measured, accounted);
+  measured = BytesPerKey(kKeyCount, value, PX(3600 * 1000), accounted);
+  printf("with expire: %.1f bytes/key, accounted %.1f\n", measured,
+         accounted);
+  measured = BytesPerKey(kKeyCount, "1", NO_EXPIRE, accounted);
+  printf("small counter: %.1f bytes/key, accounted %.1f\n", measured,
+         accounted);
+  measured = BytesPerKey(kKeyCount, std::string(100, 'a'), NO_EXPIRE,
+                         accounted);
+  printf("100-byte value: %.1f bytes/key, accounted %.1f\n", measured,
+         accounted);
+  return 0;
+}
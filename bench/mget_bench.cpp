@@ -0,0 +1,83 @@
+// 对比逐个 Get/Set 和一次 MGet/MSet 读写同一批随机键的吞吐。
+#include <chrono>
+#include <cstdio>
+#include <libcache/libcache.hpp>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace libcache {
+
+// 键的总数足够大，哈希表和对象都不在缓存中。
+static constexpr size_t kKeyCount = 2000000;
+static constexpr size_t kBatchSize = 100;
+static constexpr size_t kBatches = 20000;
+static constexpr size_t kRounds = 3;
+
+template <typename Fn>
+static double KeysPerSecond(Fn fn) {
+  double best = 0;
+  for (size_t round = 0; round < kRounds; round++) {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kBatches; i++) {
+      fn(i);
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    double rate = kBatches * kBatchSize / elapsed.count();
+    if (rate > best) {
+      best = rate;
+    }
+  }
+  return best;
+}
+
+}  // namespace libcache
+
+int main() {
+  using namespace libcache;
+
+  Options options;
+  options.db_options_array[0].hash_table_capacity = kKeyCount;
+  auto cache = Cache::New(options);
+  for (size_t i = 0; i < kKeyCount; i++) {
+    cache->Set("key:" + std::to_string(i), "value:" + std::to_string(i));
+  }
+
+  std::mt19937_64 rng(1);
+  std::vector<std::vector<std::string>> batches(kBatches);
+  std::vector<std::vector<std::pair<std::string, std::string>>> kv_batches(
+      kBatches);
+  for (size_t i = 0; i < kBatches; i++) {
+    for (size_t j = 0; j < kBatchSize; j++) {
+      auto key = "key:" + std::to_string(rng() % kKeyCount);
+      batches[i].push_back(key);
+      kv_batches[i].emplace_back(key, "value");
+    }
+  }
+
+  volatile size_t sink = 0;
+  auto get = KeysPerSecond([&](size_t i) {
+    for (const auto& key : batches[i]) {
+      sink = sink + cache->Get(key).has_value();
+    }
+  });
+  auto mget = KeysPerSecond([&](size_t i) {
+    sink = sink + cache->MGet(batches[i]).size();
+  });
+  auto set = KeysPerSecond([&](size_t i) {
+    for (const auto& [key, value] : kv_batches[i]) {
+      cache->Set(key, value);
+    }
+  });
+  auto mset = KeysPerSecond([&](size_t i) { cache->MSet(kv_batches[i]); });
+
+  printf("batch of %zu keys out of %zu\n", kBatchSize, kKeyCount);
+  printf("get  loop: %6.2f Mkeys/s, mget: %6.2f Mkeys/s (%.2fx)\n", get / 1e6,
+         mget / 1e6, mget / get);
+  printf("set  loop: %6.2f Mkeys/s, mset: %6.2f Mkeys/s (%.2fx)\n", set / 1e6,
+         mset / 1e6, mset / set);
+  delete cache;
+  return 0;
+}
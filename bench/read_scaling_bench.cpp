@@ -0,0 +1,71 @@
+// 1 到 32 个线程并发读写时的吞吐，分别测试只读和 95% 读、5% 写两种负载。
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <libcache/libcache.hpp>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace libcache {
+
+static constexpr size_t kKeyCount = 100000;
+static constexpr size_t kOpsPerThread = 500000;
+
+static std::string Key(size_t i) { return "key:" + std::to_string(i); }
+
+static double OpsPerSecond(Cache* cache, size_t thread_count,
+                           unsigned write_percent) {
+  std::atomic<bool> start = false;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < thread_count; t++) {
+    threads.emplace_back([cache, t, write_percent, &start]() {
+      std::mt19937_64 rand(t);
+      char key[32];
+      while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      for (size_t i = 0; i < kOpsPerThread; i++) {
+        auto r = rand();
+        auto size = snprintf(key, sizeof(key), "key:%zu", r % kKeyCount);
+        std::string_view view(key, size);
+        if ((r >> 32) % 100 < write_percent) {
+          cache->Set(view, "value");
+        } else {
+          cache->Get(view);
+        }
+      }
+    });
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+  return thread_count * kOpsPerThread / elapsed.count();
+}
+
+}  // namespace libcache
+
+int main() {
+  using namespace libcache;
+
+  auto cache = Cache::New();
+  for (size_t i = 0; i < kKeyCount; i++) {
+    cache->Set(Key(i), "value");
+  }
+
+  printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+  for (size_t threads : {1, 2, 4, 8, 16, 32}) {
+    printf("threads: %2zu, read only: %10.0f ops/s, 95%% read: %10.0f ops/s\n",
+           threads, OpsPerSecond(cache, threads, 0),
+           OpsPerSecond(cache, threads, 5));
+  }
+
+  delete cache;
+  return 0;
+}
@@ -0,0 +1,62 @@
+// 对比 Get、修改、Set 和一次 Update 修改同一个值的耗时。
+#include <chrono>
+#include <cstdio>
+#include <libcache/libcache.hpp>
+#include <string>
+
+namespace libcache {
+
+static constexpr size_t kKeyCount = 10000;
+static constexpr size_t kOps = 1000000;
+static constexpr size_t kRounds = 3;
+
+template <typename Fn>
+static double NanosPerOp(Fn fn) {
+  double best = 0;
+  for (size_t round = 0; round < kRounds; round++) {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kOps; i++) {
+      fn(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    if (round == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best / kOps;
+}
+
+static void Bench(size_t value_size) {
+  auto cache = Cache::New();
+  for (size_t i = 0; i < kKeyCount; i++) {
+    cache->Set("key:" + std::to_string(i), std::string(value_size, 'a'));
+  }
+
+  // 把值的第一个字节加一，长度不变。
+  auto get_set = NanosPerOp([&](size_t i) {
+    auto key = "key:" + std::to_string(i % kKeyCount);
+    auto value = cache->Get(key).value();
+    value[0]++;
+    cache->Set(key, std::move(value), KEEPTTL);
+  });
+  auto update = NanosPerOp([&](size_t i) {
+    auto key = "key:" + std::to_string(i % kKeyCount);
+    cache->Update(key, [](std::string& value, bool) {
+      value[0]++;
+      return true;
+    });
+  });
+  printf("%5zu bytes: get + set %7.1f ns, update %7.1f ns\n", value_size,
+         get_set, update);
+  delete cache;
+}
+
+}  // namespace libcache
+
+int main() {
+  libcache::Bench(16);
+  libcache::Bench(256);
+  libcache::Bench(4096);
+  return 0;
+}
@@ -0,0 +1,69 @@
+target("bench-memory")
+    set_kind("binary")
+    set_group("bench")
+    add_includedirs("$(projectdir)/include")
+    add_files("memory_bench.cpp")
+    add_deps("libcache")
+
+target("bench-ingest")
+    set_kind("binary")
+    set_group("bench")
+    add_includedirs("$(projectdir)/include")
+    add_files("ingest_bench.cpp")
+    add_deps("libcache")
+
+target("bench-read-scaling")
+    set_kind("binary")
+    set_group("bench")
+    add_includedirs("$(projectdir)/include")
+    add_files("read_scaling_bench.cpp")
+    add_deps("libcache")
+
+target("bench-clock")
+    set_kind("binary")
+    set_group("bench")
+    add_includedirs("$(projectdir)/include")
+    add_files("clock_bench.cpp")
+    add_deps("libcache")
+
+target("bench-expire")
+    set_kind("binary")
+    set_group("bench")
+    add_includedirs("$(projectdir)/include")
+    add_files("expire_bench.cpp")
+    add_deps("libcache")
+
+target("bench-lazy-free")
+    set_kind("binary")
+    set_group("bench")
+    add_includedirs("$(projectdir)/include")
+    add_files("lazy_free_bench.cpp")
+    add_deps("libcache")
+
+target("bench-mget")
+    set_kind("binary")
+    set_group("bench")
+    add_includedirs("$(projectdir)/include")
+    add_files("mget_bench.cpp")
+    add_deps("libcache")
+
+target("bench-batch")
+    set_kind("binary")
+    set_group("bench")
+    add_includedirs("$(projectdir)/include")
+    add_files("batch_bench.cpp")
+    add_deps("libcache")
+
+target("bench-update")
+    set_kind("binary")
+    set_group("bench")
+    add_includedirs("$(projectdir)/include")
+    add_files("update_bench.cpp")
+    add_deps("libcache")
+
+target("bench-eviction")
+    set_kind("binary")
+    set_group("bench")
+    add_includedirs("$(projectdir)/include")
+    add_files("eviction_bench.cpp")
+    add_deps("libcache")
@@ -0,0 +1,111 @@
+#ifndef LIBCACHE_INCLUDE_LIBCACHE_BATCH_HPP_
+#define LIBCACHE_INCLUDE_LIBCACHE_BATCH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "error.hpp"
+#include "expiration.hpp"
+
+namespace libcache {
+
+class CacheImpl;
+namespace db {
+class DB;
+}  // namespace db
+
+// Batch 中一条命令的结果，命令出错时只有 status 有意义。
+struct BatchResult {
+  Status status = Status::OK();
+  // Get、Set 的返回值。
+  std::optional<std::string> str;
+  // 其他命令返回的整数。
+  int64_t integer = 0;
+};
+
+// 类似 Redis 的 MULTI/EXEC：先把命令加入 Batch，再由 Cache::Exec 在一次加锁
+// 中依次执行，每条命令一个结果。Cache::Watch 记下键的版本，Exec 时任何一个
+// 键被修改过就不执行，调用方重新读取后重试即可，两次调用之间不持有锁。
+class Batch {
+ public:
+  Batch& Append(std::string_view key, std::string value) {
+    return Add(Op::kAppend, key, std::move(value));
+  }
+  Batch& DecrBy(std::string_view key, int64_t decrement) {
+    return Add(Op::kDecrBy, key, {}, decrement);
+  }
+  Batch& Del(std::string_view key) { return Add(Op::kDel, key); }
+  Batch& Get(std::string_view key) { return Add(Op::kGet, key); }
+  Batch& IncrBy(std::string_view key, int64_t increment) {
+    return Add(Op::kIncrBy, key, {}, increment);
+  }
+  Batch& PExpire(std::string_view key, int64_t milliseconds,
+                 uint64_t flags = 0) {
+    return Add(Op::kPExpire, key, {}, milliseconds, flags);
+  }
+  Batch& Persist(std::string_view key) { return Add(Op::kPersist, key); }
+  Batch& Pttl(std::string_view key) { return Add(Op::kPttl, key); }
+  Batch& Set(std::string_view key, std::string value, uint64_t flags = 0,
+             const Expiration& expiration = NO_EXPIRE) {
+    return Add(Op::kSet, key, std::move(value), 0, flags, expiration);
+  }
+
+  size_t size() const { return commands_.size(); }
+  bool empty() const { return commands_.empty(); }
+  // 清空命令和监视的键，Batch 可以重复使用。
+  void Clear() {
+    commands_.clear();
+    watches_.clear();
+  }
+
+ private:
+  friend class CacheImpl;
+  friend class db::DB;
+
+  enum class Op {
+    kAppend,
+    kDecrBy,
+    kDel,
+    kGet,
+    kIncrBy,
+    kPExpire,
+    kPersist,
+    kPttl,
+    kSet,
+  };
+
+  struct Command {
+    Op op;
+    std::string key;
+    std::string value;
+    int64_t integer;
+    uint64_t flags;
+    Expiration expiration;
+  };
+
+  struct Watch {
+    size_t db;
+    std::string key;
+    uint64_t version;
+  };
+
+  Batch& Add(Op op, std::string_view key, std::string value = {},
+             int64_t integer = 0, uint64_t flags = 0,
+             const Expiration& expiration = NO_EXPIRE) {
+    commands_.push_back(
+        {op, std::string(key), std::move(value), integer, flags, expiration});
+    return *this;
+  }
+
+  std::vector<Command> commands_;
+  std::vector<Watch> watches_;
+};
+
+}  // namespace libcache
+
+#endif  // LIBCACHE_INCLUDE_LIBCACHE_BATCH_HPP_
@@ -4,11 +4,15 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "batch.hpp"
 #include "error.hpp"
 #include "expiration.hpp"
 #include "options.hpp"
+#include "stats.hpp"
 #include "types.hpp"
 
 namespace libcache {
@@ -32,85 +36,126 @@ class Cache {
   virtual void LoadSnapshot(Status& status, size_t db,
                             const std::string& path) = 0;
 
+  virtual struct MemoryStats MemoryStats() = 0;
+  virtual struct MemoryStats MemoryStats(size_t db) = 0;
+  virtual struct MemoryStats MemoryStats(Status& status) = 0;
+  virtual struct MemoryStats MemoryStats(Status& status, size_t db) = 0;
+
+  virtual struct ExpireStats ExpireStats() = 0;
+  virtual struct ExpireStats ExpireStats(size_t db) = 0;
+  virtual struct ExpireStats ExpireStats(Status& status) = 0;
+  virtual struct ExpireStats ExpireStats(Status& status, size_t db) = 0;
+
+  // kAsync 模式下摘下所有键后立即返回，内存由后台线程释放。
+  virtual void FlushAll(FlushMode mode = FlushMode::kSync) = 0;
+  virtual void FlushDB(FlushMode mode = FlushMode::kSync) = 0;
+  virtual void FlushDB(size_t db, FlushMode mode = FlushMode::kSync) = 0;
+  virtual void FlushDB(Status& status, FlushMode mode = FlushMode::kSync) = 0;
+  virtual void FlushDB(Status& status, size_t db,
+                       FlushMode mode = FlushMode::kSync) = 0;
+
   // Generic 组
-  virtual int64_t Expire(const std::string& key, int64_t seconds,
+  // 返回删除的键数，值在调用线程中释放。
+  virtual int64_t Del(const std::vector<std::string>& keys) = 0;
+  virtual int64_t Del(size_t db, const std::vector<std::string>& keys) = 0;
+  virtual int64_t Del(Status& status, const std::vector<std::string>& keys) = 0;
+  virtual int64_t Del(Status& status, size_t db,
+                      const std::vector<std::string>& keys) = 0;
+
+  // 返回存在的键数，重复的键重复计数。
+  virtual int64_t Exists(const std::vector<std::string>& keys) = 0;
+  virtual int64_t Exists(size_t db, const std::vector<std::string>& keys) = 0;
+  virtual int64_t Exists(Status& status,
+                         const std::vector<std::string>& keys) = 0;
+  virtual int64_t Exists(Status& status, size_t db,
+                         const std::vector<std::string>& keys) = 0;
+
+  virtual int64_t Expire(std::string_view key, int64_t seconds,
                          uint64_t flags = 0) = 0;
-  virtual int64_t Expire(size_t db, const std::string& key, int64_t seconds,
+  virtual int64_t Expire(size_t db, std::string_view key, int64_t seconds,
                          uint64_t flags = 0) = 0;
-  virtual int64_t Expire(Status& status, const std::string& key,
-                         int64_t seconds, uint64_t flags = 0) = 0;
-  virtual int64_t Expire(Status& status, size_t db, const std::string& key,
+  virtual int64_t Expire(Status& status, std::string_view key, int64_t seconds,
+                         uint64_t flags = 0) = 0;
+  virtual int64_t Expire(Status& status, size_t db, std::string_view key,
                          int64_t seconds, uint64_t flags = 0) = 0;
 
-  virtual int64_t ExpireAt(const std::string& key, int64_t unix_time_seconds,
+  virtual int64_t ExpireAt(std::string_view key, int64_t unix_time_seconds,
                            uint64_t flags = 0) = 0;
-  virtual int64_t ExpireAt(size_t db, const std::string& key,
+  virtual int64_t ExpireAt(size_t db, std::string_view key,
                            int64_t unix_time_seconds, uint64_t flags = 0) = 0;
-  virtual int64_t ExpireAt(Status& status, const std::string& key,
+  virtual int64_t ExpireAt(Status& status, std::string_view key,
                            int64_t unix_time_seconds, uint64_t flags = 0) = 0;
-  virtual int64_t ExpireAt(Status& status, size_t db, const std::string& key,
+  virtual int64_t ExpireAt(Status& status, size_t db, std::string_view key,
                            int64_t unix_time_seconds, uint64_t flags = 0) = 0;
 
-  virtual int64_t ExpireTime(const std::string& key) = 0;
-  virtual int64_t ExpireTime(size_t db, const std::string& key) = 0;
-  virtual int64_t ExpireTime(Status& status, const std::string& key) = 0;
+  virtual int64_t ExpireTime(std::string_view key) = 0;
+  virtual int64_t ExpireTime(size_t db, std::string_view key) = 0;
+  virtual int64_t ExpireTime(Status& status, std::string_view key) = 0;
   virtual int64_t ExpireTime(Status& status, size_t db,
-                             const std::string& key) = 0;
+                             std::string_view key) = 0;
 
-  virtual std::optional<Encoding> ObjectEncoding(const std::string& key) = 0;
+  virtual std::optional<Encoding> ObjectEncoding(std::string_view key) = 0;
   virtual std::optional<Encoding> ObjectEncoding(size_t db,
-                                                 const std::string& key) = 0;
+                                                 std::string_view key) = 0;
   virtual std::optional<Encoding> ObjectEncoding(Status& status,
-                                                 const std::string& key) = 0;
+                                                 std::string_view key) = 0;
   virtual std::optional<Encoding> ObjectEncoding(Status& status, size_t db,
-                                                 const std::string& key) = 0;
+                                                 std::string_view key) = 0;
 
-  virtual std::optional<int64_t> ObjectIdleTime(const std::string& key) = 0;
+  // 键的访问频率（对数计数），只在 LFU 淘汰策略下可用。
+  virtual std::optional<int64_t> ObjectFreq(std::string_view key) = 0;
+  virtual std::optional<int64_t> ObjectFreq(size_t db,
+                                            std::string_view key) = 0;
+  virtual std::optional<int64_t> ObjectFreq(Status& status,
+                                            std::string_view key) = 0;
+  virtual std::optional<int64_t> ObjectFreq(Status& status, size_t db,
+                                            std::string_view key) = 0;
+
+  virtual std::optional<int64_t> ObjectIdleTime(std::string_view key) = 0;
   virtual std::optional<int64_t> ObjectIdleTime(size_t db,
-                                                const std::string& key) = 0;
+                                                std::string_view key) = 0;
   virtual std::optional<int64_t> ObjectIdleTime(Status& status,
-                                                const std::string& key) = 0;
+                                                std::string_view key) = 0;
   virtual std::optional<int64_t> ObjectIdleTime(Status& status, size_t db,
-                                                const std::string& key) = 0;
+                                                std::string_view key) = 0;
 
-  virtual int64_t Persist(const std::string& key) = 0;
-  virtual int64_t Persist(size_t db, const std::string& key) = 0;
-  virtual int64_t Persist(Status& status, const std::string& key) = 0;
-  virtual int64_t Persist(Status& status, size_t db,
-                          const std::string& key) = 0;
+  virtual int64_t Persist(std::string_view key) = 0;
+  virtual int64_t Persist(size_t db, std::string_view key) = 0;
+  virtual int64_t Persist(Status& status, std::string_view key) = 0;
+  virtual int64_t Persist(Status& status, size_t db, std::string_view key) = 0;
 
-  virtual int64_t PExpire(const std::string& key, int64_t milliseconds,
+  virtual int64_t PExpire(std::string_view key, int64_t milliseconds,
                           uint64_t flags = 0) = 0;
-  virtual int64_t PExpire(size_t db, const std::string& key,
-                          int64_t milliseconds, uint64_t flags = 0) = 0;
-  virtual int64_t PExpire(Status& status, const std::string& key,
+  virtual int64_t PExpire(size_t db, std::string_view key, int64_t milliseconds,
+                          uint64_t flags = 0) = 0;
+  virtual int64_t PExpire(Status& status, std::string_view key,
                           int64_t milliseconds, uint64_t flags = 0) = 0;
-  virtual int64_t PExpire(Status& status, size_t db, const std::string& key,
+  virtual int64_t PExpire(Status& status, size_t db, std::string_view key,
                           int64_t milliseconds, uint64_t flags = 0) = 0;
 
-  virtual int64_t PExpireAt(const std::string& key,
+  virtual int64_t PExpireAt(std::string_view key,
                             int64_t unix_time_milliseconds,
                             uint64_t flags = 0) = 0;
-  virtual int64_t PExpireAt(Status& status, const std::string& key,
+  virtual int64_t PExpireAt(Status& status, std::string_view key,
                             int64_t unix_time_milliseconds,
                             uint64_t flags = 0) = 0;
-  virtual int64_t PExpireAt(size_t db, const std::string& key,
+  virtual int64_t PExpireAt(size_t db, std::string_view key,
                             int64_t unix_time_milliseconds,
                             uint64_t flags = 0) = 0;
-  virtual int64_t PExpireAt(Status& status, size_t db, const std::string& key,
+  virtual int64_t PExpireAt(Status& status, size_t db, std::string_view key,
                             int64_t unix_time_milliseconds,
                             uint64_t flags = 0) = 0;
 
-  virtual int64_t PExpireTime(const std::string& key) = 0;
-  virtual int64_t PExpireTime(size_t db, const std::string& key) = 0;
-  virtual int64_t PExpireTime(Status& status, const std::string& key) = 0;
+  virtual int64_t PExpireTime(std::string_view key) = 0;
+  virtual int64_t PExpireTime(size_t db, std::string_view key) = 0;
+  virtual int64_t PExpireTime(Status& status, std::string_view key) = 0;
   virtual int64_t PExpireTime(Status& status, size_t db,
-                              const std::string& key) = 0;
+                              std::string_view key) = 0;
 
-  virtual int64_t Pttl(const std::string& key) = 0;
-  virtual int64_t Pttl(size_t db, const std::string& key) = 0;
-  virtual int64_t Pttl(Status& status, const std::string& key) = 0;
-  virtual int64_t Pttl(Status& status, size_t db, const std::string& key) = 0;
+  virtual int64_t Pttl(std::string_view key) = 0;
+  virtual int64_t Pttl(size_t db, std::string_view key) = 0;
+  virtual int64_t Pttl(Status& status, std::string_view key) = 0;
+  virtual int64_t Pttl(Status& status, size_t db, std::string_view key) = 0;
 
   virtual int64_t Touch(const std::vector<std::string>& keys) = 0;
   virtual int64_t Touch(size_t db, const std::vector<std::string>& keys) = 0;
@@ -119,71 +164,175 @@ class Cache {
   virtual int64_t Touch(Status& status, size_t db,
                         const std::vector<std::string>& keys) = 0;
 
-  virtual int64_t Ttl(const std::string& key) = 0;
-  virtual int64_t Ttl(size_t db, const std::string& key) = 0;
-  virtual int64_t Ttl(Status& status, const std::string& key) = 0;
-  virtual int64_t Ttl(Status& status, size_t db, const std::string& key) = 0;
+  virtual int64_t Ttl(std::string_view key) = 0;
+  virtual int64_t Ttl(size_t db, std::string_view key) = 0;
+  virtual int64_t Ttl(Status& status, std::string_view key) = 0;
+  virtual int64_t Ttl(Status& status, size_t db, std::string_view key) = 0;
 
-  virtual enum Type Type(const std::string& key) = 0;
-  virtual enum Type Type(size_t db, const std::string& key) = 0;
-  virtual enum Type Type(Status& status, const std::string& key) = 0;
-  virtual enum Type Type(Status& status, size_t db, const std::string& key) = 0;
+  virtual enum Type Type(std::string_view key) = 0;
+  virtual enum Type Type(size_t db, std::string_view key) = 0;
+  virtual enum Type Type(Status& status, std::string_view key) = 0;
+  virtual enum Type Type(Status& status, size_t db, std::string_view key) = 0;
+
+  // 删除键，值超过 DBOptions::lazy_free_threshold 时由后台线程释放。
+  virtual int64_t Unlink(const std::vector<std::string>& keys) = 0;
+  virtual int64_t Unlink(size_t db, const std::vector<std::string>& keys) = 0;
+  virtual int64_t Unlink(Status& status,
+                         const std::vector<std::string>& keys) = 0;
+  virtual int64_t Unlink(Status& status, size_t db,
+                         const std::vector<std::string>& keys) = 0;
 
   // String 组
-  virtual int64_t Append(const std::string& key, const std::string& value) = 0;
-  virtual int64_t Append(size_t db, const std::string& key,
+  virtual int64_t Append(std::string_view key, const std::string& value) = 0;
+  virtual int64_t Append(size_t db, std::string_view key,
                          const std::string& value) = 0;
-  virtual int64_t Append(Status& status, const std::string& key,
+  virtual int64_t Append(Status& status, std::string_view key,
                          const std::string& value) = 0;
-  virtual int64_t Append(Status& status, size_t db, const std::string& key,
+  virtual int64_t Append(Status& status, size_t db, std::string_view key,
                          const std::string& value) = 0;
+  // 右值版本直接接管 value 的缓冲区，不再复制。
+  virtual int64_t Append(std::string_view key, std::string&& value) = 0;
+  virtual int64_t Append(size_t db, std::string_view key,
+                         std::string&& value) = 0;
+  virtual int64_t Append(Status& status, std::string_view key,
+                         std::string&& value) = 0;
+  virtual int64_t Append(Status& status, size_t db, std::string_view key,
+                         std::string&& value) = 0;
 
-  virtual int64_t Decr(const std::string& key) = 0;
-  virtual int64_t Decr(size_t db, const std::string& key) = 0;
-  virtual int64_t Decr(Status& status, const std::string& key) = 0;
-  virtual int64_t Decr(Status& status, size_t db, const std::string& key) = 0;
+  virtual int64_t Decr(std::string_view key) = 0;
+  virtual int64_t Decr(size_t db, std::string_view key) = 0;
+  virtual int64_t Decr(Status& status, std::string_view key) = 0;
+  virtual int64_t Decr(Status& status, size_t db, std::string_view key) = 0;
 
-  virtual int64_t DecrBy(const std::string& key, int64_t decrement) = 0;
-  virtual int64_t DecrBy(size_t db, const std::string& key,
+  virtual int64_t DecrBy(std::string_view key, int64_t decrement) = 0;
+  virtual int64_t DecrBy(size_t db, std::string_view key,
                          int64_t decrement) = 0;
-  virtual int64_t DecrBy(Status& status, const std::string& key,
+  virtual int64_t DecrBy(Status& status, std::string_view key,
                          int64_t decrement) = 0;
-  virtual int64_t DecrBy(Status& status, size_t db, const std::string& key,
+  virtual int64_t DecrBy(Status& status, size_t db, std::string_view key,
                          int64_t decrement) = 0;
 
-  virtual int64_t Incr(const std::string& key) = 0;
-  virtual int64_t Incr(size_t db, const std::string& key) = 0;
-  virtual int64_t Incr(Status& status, const std::string& key) = 0;
-  virtual int64_t Incr(Status& status, size_t db, const std::string& key) = 0;
+  virtual int64_t Incr(std::string_view key) = 0;
+  virtual int64_t Incr(size_t db, std::string_view key) = 0;
+  virtual int64_t Incr(Status& status, std::string_view key) = 0;
+  virtual int64_t Incr(Status& status, size_t db, std::string_view key) = 0;
 
-  virtual int64_t IncrBy(const std::string& key, int64_t increment) = 0;
-  virtual int64_t IncrBy(size_t db, const std::string& key,
+  virtual int64_t IncrBy(std::string_view key, int64_t increment) = 0;
+  virtual int64_t IncrBy(size_t db, std::string_view key,
                          int64_t increment) = 0;
-  virtual int64_t IncrBy(Status& status, const std::string& key,
+  virtual int64_t IncrBy(Status& status, std::string_view key,
                          int64_t increment) = 0;
-  virtual int64_t IncrBy(Status& status, size_t db, const std::string& key,
+  virtual int64_t IncrBy(Status& status, size_t db, std::string_view key,
                          int64_t increment) = 0;
 
-  virtual std::optional<std::string> Get(const std::string& key) = 0;
-  virtual std::optional<std::string> Get(size_t db, const std::string& key) = 0;
+  virtual std::optional<std::string> Get(std::string_view key) = 0;
+  virtual std::optional<std::string> Get(size_t db, std::string_view key) = 0;
   virtual std::optional<std::string> Get(Status& status,
-                                         const std::string& key) = 0;
+                                         std::string_view key) = 0;
   virtual std::optional<std::string> Get(Status& status, size_t db,
-                                         const std::string& key) = 0;
+                                         std::string_view key) = 0;
+
+  // 返回值的只读句柄，较长的值不复制数据。键不存在时返回空指针。
+  virtual ValueRef GetRef(std::string_view key) = 0;
+  virtual ValueRef GetRef(size_t db, std::string_view key) = 0;
+  virtual ValueRef GetRef(Status& status, std::string_view key) = 0;
+  virtual ValueRef GetRef(Status& status, size_t db, std::string_view key) = 0;
+
+  // 一次加锁读取多个键，不存在或不是字符串的键对应空值。
+  virtual std::vector<std::optional<std::string>> MGet(
+      const std::vector<std::string>& keys) = 0;
+  virtual std::vector<std::optional<std::string>> MGet(
+      size_t db, const std::vector<std::string>& keys) = 0;
+  virtual std::vector<std::optional<std::string>> MGet(
+      Status& status, const std::vector<std::string>& keys) = 0;
+  virtual std::vector<std::optional<std::string>> MGet(
+      Status& status, size_t db, const std::vector<std::string>& keys) = 0;
+
+  virtual void MSet(
+      const std::vector<std::pair<std::string, std::string>>& kvs) = 0;
+  virtual void MSet(
+      size_t db,
+      const std::vector<std::pair<std::string, std::string>>& kvs) = 0;
+  virtual void MSet(
+      Status& status,
+      const std::vector<std::pair<std::string, std::string>>& kvs) = 0;
+  virtual void MSet(
+      Status& status, size_t db,
+      const std::vector<std::pair<std::string, std::string>>& kvs) = 0;
+
+  // 所有键都不存在时全部写入并返回 1，否则不写入并返回 0。
+  virtual int64_t MSetNX(
+      const std::vector<std::pair<std::string, std::string>>& kvs) = 0;
+  virtual int64_t MSetNX(
+      size_t db,
+      const std::vector<std::pair<std::string, std::string>>& kvs) = 0;
+  virtual int64_t MSetNX(
+      Status& status,
+      const std::vector<std::pair<std::string, std::string>>& kvs) = 0;
+  virtual int64_t MSetNX(
+      Status& status, size_t db,
+      const std::vector<std::pair<std::string, std::string>>& kvs) = 0;
 
   virtual std::optional<std::string> Set(
-      const std::string& key, const std::string& value, uint64_t flags = 0,
+      std::string_view key, const std::string& value, uint64_t flags = 0,
       const Expiration& expiration = NO_EXPIRE) = 0;
   virtual std::optional<std::string> Set(
-      size_t db, const std::string& key, const std::string& value,
+      size_t db, std::string_view key, const std::string& value,
       uint64_t flags = 0, const Expiration& expiration = NO_EXPIRE) = 0;
   virtual std::optional<std::string> Set(
-      Status& status, const std::string& key, const std::string& value,
+      Status& status, std::string_view key, const std::string& value,
       uint64_t flags = 0, const Expiration& expiration = NO_EXPIRE) = 0;
   virtual std::optional<std::string> Set(
-      Status& status, size_t db, const std::string& key,
+      Status& status, size_t db, std::string_view key,
       const std::string& value, uint64_t flags = 0,
       const Expiration& expiration = NO_EXPIRE) = 0;
+  virtual std::optional<std::string> Set(
+      std::string_view key, std::string&& value, uint64_t flags = 0,
+      const Expiration& expiration = NO_EXPIRE) = 0;
+  virtual std::optional<std::string> Set(
+      size_t db, std::string_view key, std::string&& value,
+      uint64_t flags = 0, const Expiration& expiration = NO_EXPIRE) = 0;
+  virtual std::optional<std::string> Set(
+      Status& status, std::string_view key, std::string&& value,
+      uint64_t flags = 0, const Expiration& expiration = NO_EXPIRE) = 0;
+  virtual std::optional<std::string> Set(
+      Status& status, size_t db, std::string_view key, std::string&& value,
+      uint64_t flags = 0, const Expiration& expiration = NO_EXPIRE) = 0;
+
+  // 持有键所在分片的锁时对值调用 fn，只查找一次，kRaw 编码的值原地修改，
+  // 有 GetRef 的句柄共享时先复制一次。fn 返回 true 表示修改了值，此时更新
+  // 版本号并返回 1，否则返回 0，fn 的约定见 UpdateFn。expiration 为
+  // NO_EXPIRE 时保留原有的过期时间。fn 中不能再调用 Cache。
+  virtual int64_t Update(std::string_view key, const UpdateFn& fn,
+                         const Expiration& expiration = NO_EXPIRE) = 0;
+  virtual int64_t Update(size_t db, std::string_view key, const UpdateFn& fn,
+                         const Expiration& expiration = NO_EXPIRE) = 0;
+  virtual int64_t Update(Status& status, std::string_view key,
+                         const UpdateFn& fn,
+                         const Expiration& expiration = NO_EXPIRE) = 0;
+  virtual int64_t Update(Status& status, size_t db, std::string_view key,
+                         const UpdateFn& fn,
+                         const Expiration& expiration = NO_EXPIRE) = 0;
+
+  // Transaction 组
+  // 记下键的当前版本，之后 Exec 这个 batch 时任何一个键被修改过都不执行。
+  virtual void Watch(Batch& batch, const std::vector<std::string>& keys) = 0;
+  virtual void Watch(size_t db, Batch& batch,
+                     const std::vector<std::string>& keys) = 0;
+  virtual void Watch(Status& status, Batch& batch,
+                     const std::vector<std::string>& keys) = 0;
+  virtual void Watch(Status& status, size_t db, Batch& batch,
+                     const std::vector<std::string>& keys) = 0;
+
+  // 在一次加锁中执行 batch 中的命令，每条命令一个结果。监视的键被修改过，或者
+  // 是在其他 db 中监视的，返回空值。
+  virtual std::optional<std::vector<BatchResult>> Exec(const Batch& batch) = 0;
+  virtual std::optional<std::vector<BatchResult>> Exec(
+      size_t db, const Batch& batch) = 0;
+  virtual std::optional<std::vector<BatchResult>> Exec(
+      Status& status, const Batch& batch) = 0;
+  virtual std::optional<std::vector<BatchResult>> Exec(
+      Status& status, size_t db, const Batch& batch) = 0;
 };
 
 }  // namespace libcache
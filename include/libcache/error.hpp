@@ -20,6 +20,8 @@ static constexpr size_t kCorrupt = 9;
 static constexpr size_t kChecksumNotMatch = 10;
 static constexpr size_t kInvalidOptions = 11;
 static constexpr size_t kInvalidInt64 = 12;
+static constexpr size_t kOutOfMemory = 13;
+static constexpr size_t kNoLFUPolicy = 14;
 
 class Status {
  public:
@@ -63,6 +65,15 @@ class Status {
   static Status InvalidInt64() {
     return {kInvalidInt64, "value is not an integer or out of range"};
   }
+  static Status OutOfMemory() {
+    return {kOutOfMemory,
+            "OOM command not allowed when used memory > 'maxmemory'"};
+  }
+  static Status NoLFUPolicy() {
+    return {kNoLFUPolicy,
+            "An LFU eviction policy is not selected, access frequency not "
+            "tracked"};
+  }
 
  private:
   size_t code_;
@@ -1,11 +1,13 @@
 #ifndef LIBCACHE_INCLUDE_LIBCACHE_LIBCACHE_HPP_
 #define LIBCACHE_INCLUDE_LIBCACHE_LIBCACHE_HPP_
 
+#include "batch.hpp"
 #include "cache.hpp"
 #include "error.hpp"
 #include "expiration.hpp"
 #include "flags.hpp"
 #include "options.hpp"
+#include "stats.hpp"
 #include "types.hpp"
 
 #endif  // LIBCACHE_INCLUDE_LIBCACHE_LIBCACHE_HPP_
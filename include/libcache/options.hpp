@@ -6,13 +6,72 @@
 
 namespace libcache {
 
+enum class ClockMode {
+  // 每次读取精确时钟。
+  kPrecise,
+  // 读取精度为内核 tick 的粗粒度时钟，开销更小。
+  kCoarse,
+};
+
+// 超过 maxmemory 后写命令的处理方式。
+enum class EvictionPolicy {
+  // 拒绝可能增加内存的写命令。
+  kNoEviction,
+  // 在所有键中淘汰最久没有访问的键，按采样近似 LRU。
+  kAllKeysLRU,
+  // 只在有过期时间的键中淘汰，没有这样的键时拒绝写命令。
+  kVolatileLRU,
+  // 按访问频率淘汰最少使用的键，频率随时间衰减，见 DBOptions::lfu_log_factor。
+  kAllKeysLFU,
+  kVolatileLFU,
+  // 在有过期时间的键中淘汰剩余时间最短的键，按时间轮中的槽顺序直接选取，
+  // 不采样。只有一圈最低层时间轮以内的键是精确排序的，更远的键按粗粒度的桶
+  // 近似排序。
+  kVolatileTTL,
+};
+
 struct DBOptions {
-  size_t time_wheel_size = 1;
+  // 分层时间轮每层的槽数，向上取整到 2 的幂，刻度为 Options::timer_interval。
+  size_t time_wheel_size = 64;
+  // 键空间分片数，每个分片独立加锁。
+  size_t shard_count = 16;
+  // 哈希表初始可容纳的键数（所有分片合计），超出后按 2 倍扩容。
+  size_t hash_table_capacity = 0;
+  // 哈希表的最大负载因子，取值范围 (0, 1)。
+  double hash_table_load_factor = 0.875;
+  // 对象所在的 slab 使用 2MB 大页，系统不支持时退回普通页。
+  bool huge_pages = false;
+  // 记录访问时间（OBJECT IDLETIME 等）使用的时钟，过期判断始终使用精确时钟。
+  ClockMode access_clock = ClockMode::kCoarse;
+  // 每次定时器回调中主动过期的时间预算，单位微秒。已到期的键比例较高、预算
+  // 不够用时逐次加倍，最多占 Options::timer_interval 的
+  // expire_cycle_max_percent%。
+  size_t expire_cycle_budget_us = 1000;
+  size_t expire_cycle_max_percent = 25;
+  // 删除、覆盖或过期的值超过这个字节数时，交给后台线程释放，为 0 时不使用。
+  size_t lazy_free_threshold = 64 * 1024;
+  // DB 的内存上限，单位字节，为 0 时不限制。超过后按 eviction_policy 处理。
+  size_t maxmemory = 0;
+  EvictionPolicy eviction_policy = EvictionPolicy::kNoEviction;
+  // 每轮淘汰从一个分片中采样的键数，越大越接近精确的 LRU，开销也越大。
+  size_t eviction_samples = 5;
+  // LFU 策略的对数计数因子，越大计数增长越慢，为 10 时约一百万次访问计满。
+  size_t lfu_log_factor = 10;
+  // 键每空闲这么多毫秒，访问频率减 1，为 0 时不衰减。
+  int64_t lfu_decay_time_ms = 60 * 1000;
+  // 在键空间前加一层 W-TinyLFU 准入：Set 写入的新键先进入占 maxmemory 的
+  // admission_window_percent% 的窗口，离开窗口时用 count-min sketch 估计的
+  // 访问频率和淘汰池选出的键比较，频率不更高的一方被淘汰。只用于 allkeys
+  // 淘汰策略，sketch 额外占用 maxmemory 的 3%~6%。
+  bool admission_filter = false;
+  size_t admission_window_percent = 1;
 };
 
 struct Options {
   size_t timer_interval = 1000;
   std::vector<DBOptions> db_options_array = {DBOptions{}};
+  // 所有 DB 合计的内存上限，为 0 时不限制。
+  size_t maxmemory = 0;
 };
 
 }  // namespace libcache
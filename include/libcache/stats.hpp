@@ -0,0 +1,66 @@
+#ifndef LIBCACHE_INCLUDE_LIBCACHE_STATS_HPP_
+#define LIBCACHE_INCLUDE_LIBCACHE_STATS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace libcache {
+
+// 一个大小级别的 slab 使用情况，利用率为 used_blocks / total_blocks。
+struct SlabClassStats {
+  size_t block_size = 0;
+  size_t slabs = 0;
+  size_t used_blocks = 0;
+  size_t total_blocks = 0;
+};
+
+struct MemoryStats {
+  // 向系统申请的 2MB 区域数，以及其中使用大页的区域数。
+  size_t regions = 0;
+  size_t huge_page_regions = 0;
+  // 已切出的 slab 数，包括等待复用的空闲 slab。
+  size_t slabs = 0;
+  size_t free_slabs = 0;
+  // 已分配出去的块的总字节数。
+  size_t used_bytes = 0;
+  std::vector<SlabClassStats> slab_classes;
+  // 键、值、对象头、过期项和哈希表占用的字节数，以及 used_memory 的历史峰值。
+  size_t used_memory = 0;
+  size_t peak_memory = 0;
+  size_t maxmemory = 0;
+  // 超过 maxmemory 后淘汰的键数。
+  size_t evicted_keys = 0;
+  // 离开准入窗口时频率不够而被淘汰的新键数，也计入 evicted_keys。
+  size_t rejected_keys = 0;
+  // 交给后台线程、还没释放完的对象数，以及后台线程累计释放的对象数。一个
+  // Cache 的所有 DB 共用一个后台线程，这两项是整个 Cache 的值。
+  size_t lazy_free_pending = 0;
+  size_t lazy_freed_objects = 0;
+  // 向系统申请的字节数和 used_memory 之比，slab 区域中的空闲块和空闲 slab
+  // 都算作碎片。
+  double fragmentation_ratio = 0;
+};
+
+struct ExpireStats {
+  // 有过期时间的键数，以及其中已经到期、还没有删除的键数。
+  size_t volatile_keys = 0;
+  size_t backlog = 0;
+  // 访问时发现已过期而删除的键数。
+  size_t lazy_expired_keys = 0;
+  // 主动过期的周期数，以及累计删除的键数和耗时（微秒）。
+  size_t cycles = 0;
+  size_t expired_keys = 0;
+  int64_t time_us = 0;
+  // 还没到期就被淘汰的有过期时间的键数，和上面自然过期的键数分开统计。
+  size_t evicted_keys = 0;
+  // 最近一个周期删除的键数和耗时。
+  size_t last_cycle_expired_keys = 0;
+  int64_t last_cycle_time_us = 0;
+  // 当前每个周期的时间预算，随已到期键的比例调整。
+  int64_t cycle_budget_us = 0;
+};
+
+}  // namespace libcache
+
+#endif  // LIBCACHE_INCLUDE_LIBCACHE_STATS_HPP_
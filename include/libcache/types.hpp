@@ -2,6 +2,8 @@
 #define LIBCACHE_INCLUDE_LIBCACHE_TYPES_HPP_
 
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 
 namespace libcache {
@@ -14,8 +16,24 @@ enum class Type {
 enum class Encoding {
   kRaw,
   kInt,
+  kEmbStr,
 };
 
+enum class FlushMode {
+  // 在调用线程中释放所有对象。
+  kSync,
+  // 清空后立即返回，对象由后台线程释放。
+  kAsync,
+};
+
+// 只读的值句柄，持有期间值的内容不会改变，读取时不需要加锁。
+using ValueRef = std::shared_ptr<const std::string>;
+
+// Cache::Update 的回调。value 是键当前的值，键不存在时为空且 exists 为 false。
+// 回调直接修改 value，返回值表示是否修改了 value。kRaw 编码的 value 就是存储
+// 中的值，返回 false 时不能修改它；其他编码的 value 是副本，返回 false 时丢弃。
+using UpdateFn = std::function<bool(std::string& value, bool exists)>;
+
 }  // namespace libcache
 
 #endif  // LIBCACHE_INCLUDE_LIBCACHE_TYPES_HPP_
@@ -33,6 +33,42 @@ static Status CheckOptions(const Options& options) {
       return Status::InvalidOptions(
           "db_options.time_wheel_size must be greater than zero");
     }
+    if (db_options.shard_count == 0) {
+      return Status::InvalidOptions(
+          "db_options.shard_count must be greater than zero");
+    }
+    if (db_options.expire_cycle_budget_us == 0) {
+      return Status::InvalidOptions(
+          "db_options.expire_cycle_budget_us must be greater than zero");
+    }
+    if (db_options.expire_cycle_max_percent == 0 ||
+        db_options.expire_cycle_max_percent > 100) {
+      return Status::InvalidOptions(
+          "db_options.expire_cycle_max_percent must be in (0, 100]");
+    }
+    if (db_options.eviction_samples == 0) {
+      return Status::InvalidOptions(
+          "db_options.eviction_samples must be greater than zero");
+    }
+    if (db_options.admission_filter) {
+      if (db_options.maxmemory == 0 ||
+          (db_options.eviction_policy != EvictionPolicy::kAllKeysLRU &&
+           db_options.eviction_policy != EvictionPolicy::kAllKeysLFU)) {
+        return Status::InvalidOptions(
+            "db_options.admission_filter requires db_options.maxmemory and "
+            "an allkeys eviction policy");
+      }
+      if (db_options.admission_window_percent == 0 ||
+          db_options.admission_window_percent > 100) {
+        return Status::InvalidOptions(
+            "db_options.admission_window_percent must be in (0, 100]");
+      }
+    }
+    if (!(db_options.hash_table_load_factor > 0 &&
+          db_options.hash_table_load_factor < 1)) {
+      return Status::InvalidOptions(
+          "db_options.hash_table_load_factor must be in (0, 1)");
+    }
   }
   return Status::OK();
 }
@@ -46,10 +82,12 @@ CacheImpl* CacheImpl::New(Status& status, const Options& options) {
 }
 
 CacheImpl::CacheImpl(const Options& options)
-    : dbs_(options.db_options_array.size()),
+    : memory_(options.maxmemory),
+      dbs_(options.db_options_array.size()),
       timer(options.timer_interval, [this]() { TimerCallback(); }) {
   for (size_t i = 0; i < dbs_.size(); i++) {
-    dbs_[i] = make_unique<DB>(options.db_options_array[i]);
+    dbs_[i] = make_unique<DB>(options.db_options_array[i],
+                              options.timer_interval, lazy_free_, memory_);
   }
   timer.Start();
 }
@@ -98,4 +136,78 @@ void CacheImpl::LoadSnapshot(Status& status, size_t db, const string& path) {
   dbs_[db]->LoadSnapshot(status, path);
 }
 
+MemoryStats CacheImpl::MemoryStats() { return MemoryStats(current_db_); }
+
+MemoryStats CacheImpl::MemoryStats(size_t db) {
+  auto status = Status::OK();
+  auto result = MemoryStats(status, db);
+  status.ThrowIfError();
+  return result;
+}
+
+MemoryStats CacheImpl::MemoryStats(Status& status) {
+  return MemoryStats(status, current_db_);
+}
+
+MemoryStats CacheImpl::MemoryStats(Status& status, size_t db) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return {};
+  }
+  auto stats = dbs_[db]->MemoryStats();
+  stats.lazy_free_pending = lazy_free_.pending();
+  stats.lazy_freed_objects = lazy_free_.freed();
+  return stats;
+}
+
+ExpireStats CacheImpl::ExpireStats() { return ExpireStats(current_db_); }
+
+ExpireStats CacheImpl::ExpireStats(size_t db) {
+  auto status = Status::OK();
+  auto result = ExpireStats(status, db);
+  status.ThrowIfError();
+  return result;
+}
+
+ExpireStats CacheImpl::ExpireStats(Status& status) {
+  return ExpireStats(status, current_db_);
+}
+
+ExpireStats CacheImpl::ExpireStats(Status& status, size_t db) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return {};
+  }
+  return dbs_[db]->ExpireStats();
+}
+
+void CacheImpl::FlushAll(FlushMode mode) {
+  for (auto& db : dbs_) {
+    db->FlushDB(mode);
+  }
+}
+
+void CacheImpl::FlushDB(FlushMode mode) { FlushDB(current_db_, mode); }
+
+void CacheImpl::FlushDB(size_t db, FlushMode mode) {
+  auto status = Status::OK();
+  FlushDB(status, db, mode);
+  status.ThrowIfError();
+}
+
+void CacheImpl::FlushDB(Status& status, FlushMode mode) {
+  FlushDB(status, current_db_, mode);
+}
+
+void CacheImpl::FlushDB(Status& status, size_t db, FlushMode mode) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return;
+  }
+  dbs_[db]->FlushDB(mode);
+}
+
 }  // namespace libcache
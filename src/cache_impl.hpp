@@ -1,6 +1,9 @@
 #ifndef LIBCACHE_SRC_CACHE_IMPL_HPP_
 #define LIBCACHE_SRC_CACHE_IMPL_HPP_
 
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "db/db.hpp"
@@ -25,83 +28,117 @@ class CacheImpl : public Cache {
   void LoadSnapshot(Status& status, size_t db,
                     const std::string& path) override;
 
+  struct MemoryStats MemoryStats() override;
+  struct MemoryStats MemoryStats(size_t db) override;
+  struct MemoryStats MemoryStats(Status& status) override;
+  struct MemoryStats MemoryStats(Status& status, size_t db) override;
+
+  struct ExpireStats ExpireStats() override;
+  struct ExpireStats ExpireStats(size_t db) override;
+  struct ExpireStats ExpireStats(Status& status) override;
+  struct ExpireStats ExpireStats(Status& status, size_t db) override;
+
+  void FlushAll(FlushMode mode = FlushMode::kSync) override;
+  void FlushDB(FlushMode mode = FlushMode::kSync) override;
+  void FlushDB(size_t db, FlushMode mode = FlushMode::kSync) override;
+  void FlushDB(Status& status, FlushMode mode = FlushMode::kSync) override;
+  void FlushDB(Status& status, size_t db,
+               FlushMode mode = FlushMode::kSync) override;
+
   // Generic 组
-  int64_t Expire(const std::string& key, int64_t seconds,
+  int64_t Del(const std::vector<std::string>& keys) override;
+  int64_t Del(size_t db, const std::vector<std::string>& keys) override;
+  int64_t Del(Status& status, const std::vector<std::string>& keys) override;
+  int64_t Del(Status& status, size_t db,
+              const std::vector<std::string>& keys) override;
+
+  int64_t Exists(const std::vector<std::string>& keys) override;
+  int64_t Exists(size_t db, const std::vector<std::string>& keys) override;
+  int64_t Exists(Status& status, const std::vector<std::string>& keys) override;
+  int64_t Exists(Status& status, size_t db,
+                 const std::vector<std::string>& keys) override;
+
+  int64_t Expire(std::string_view key, int64_t seconds,
                  uint64_t flags = 0) override;
-  int64_t Expire(size_t db, const std::string& key, int64_t seconds,
+  int64_t Expire(size_t db, std::string_view key, int64_t seconds,
                  uint64_t flags = 0) override;
-  int64_t Expire(Status& status, const std::string& key, int64_t seconds,
+  int64_t Expire(Status& status, std::string_view key, int64_t seconds,
                  uint64_t flags = 0) override;
-  int64_t Expire(Status& status, size_t db, const std::string& key,
+  int64_t Expire(Status& status, size_t db, std::string_view key,
                  int64_t seconds, uint64_t flags = 0) override;
 
-  int64_t ExpireAt(const std::string& key, int64_t unix_time_seconds,
+  int64_t ExpireAt(std::string_view key, int64_t unix_time_seconds,
                    uint64_t flags = 0) override;
-  int64_t ExpireAt(size_t db, const std::string& key, int64_t unix_time_seconds,
+  int64_t ExpireAt(size_t db, std::string_view key, int64_t unix_time_seconds,
                    uint64_t flags = 0) override;
-  int64_t ExpireAt(Status& status, const std::string& key,
+  int64_t ExpireAt(Status& status, std::string_view key,
                    int64_t unix_time_seconds, uint64_t flags = 0) override;
-  int64_t ExpireAt(Status& status, size_t db, const std::string& key,
+  int64_t ExpireAt(Status& status, size_t db, std::string_view key,
                    int64_t unix_time_seconds, uint64_t flags = 0) override;
 
-  int64_t ExpireTime(const std::string& key) override;
-  int64_t ExpireTime(size_t db, const std::string& key) override;
-  int64_t ExpireTime(Status& status, const std::string& key) override;
-  int64_t ExpireTime(Status& status, size_t db,
-                     const std::string& key) override;
+  int64_t ExpireTime(std::string_view key) override;
+  int64_t ExpireTime(size_t db, std::string_view key) override;
+  int64_t ExpireTime(Status& status, std::string_view key) override;
+  int64_t ExpireTime(Status& status, size_t db, std::string_view key) override;
 
-  std::optional<Encoding> ObjectEncoding(const std::string& key) override;
+  std::optional<Encoding> ObjectEncoding(std::string_view key) override;
   std::optional<Encoding> ObjectEncoding(size_t db,
-                                         const std::string& key) override;
+                                         std::string_view key) override;
   std::optional<Encoding> ObjectEncoding(Status& status,
-                                         const std::string& key) override;
+                                         std::string_view key) override;
   std::optional<Encoding> ObjectEncoding(Status& status, size_t db,
-                                         const std::string& key) override;
+                                         std::string_view key) override;
+
+  std::optional<int64_t> ObjectFreq(std::string_view key) override;
+  std::optional<int64_t> ObjectFreq(size_t db, std::string_view key) override;
+  std::optional<int64_t> ObjectFreq(Status& status,
+                                    std::string_view key) override;
+  std::optional<int64_t> ObjectFreq(Status& status, size_t db,
+                                    std::string_view key) override;
 
-  std::optional<int64_t> ObjectIdleTime(const std::string& key) override;
+  std::optional<int64_t> ObjectIdleTime(std::string_view key) override;
   std::optional<int64_t> ObjectIdleTime(size_t db,
-                                        const std::string& key) override;
+                                        std::string_view key) override;
   std::optional<int64_t> ObjectIdleTime(Status& status,
-                                        const std::string& key) override;
+                                        std::string_view key) override;
   std::optional<int64_t> ObjectIdleTime(Status& status, size_t db,
-                                        const std::string& key) override;
+                                        std::string_view key) override;
 
-  int64_t Persist(const std::string& key) override;
-  int64_t Persist(size_t db, const std::string& key) override;
-  int64_t Persist(Status& status, const std::string& key) override;
-  int64_t Persist(Status& status, size_t db, const std::string& key) override;
+  int64_t Persist(std::string_view key) override;
+  int64_t Persist(size_t db, std::string_view key) override;
+  int64_t Persist(Status& status, std::string_view key) override;
+  int64_t Persist(Status& status, size_t db, std::string_view key) override;
 
-  int64_t PExpire(const std::string& key, int64_t milliseconds,
+  int64_t PExpire(std::string_view key, int64_t milliseconds,
                   uint64_t flags = 0) override;
-  int64_t PExpire(size_t db, const std::string& key, int64_t milliseconds,
+  int64_t PExpire(size_t db, std::string_view key, int64_t milliseconds,
                   uint64_t flags = 0) override;
-  int64_t PExpire(Status& status, const std::string& key, int64_t milliseconds,
+  int64_t PExpire(Status& status, std::string_view key, int64_t milliseconds,
                   uint64_t flags = 0) override;
-  int64_t PExpire(Status& status, size_t db, const std::string& key,
+  int64_t PExpire(Status& status, size_t db, std::string_view key,
                   int64_t milliseconds, uint64_t flags = 0) override;
 
-  int64_t PExpireAt(const std::string& key, int64_t unix_time_milliseconds,
+  int64_t PExpireAt(std::string_view key, int64_t unix_time_milliseconds,
                     uint64_t flags = 0) override;
-  int64_t PExpireAt(Status& status, const std::string& key,
+  int64_t PExpireAt(Status& status, std::string_view key,
                     int64_t unix_time_milliseconds,
                     uint64_t flags = 0) override;
-  int64_t PExpireAt(size_t db, const std::string& key,
+  int64_t PExpireAt(size_t db, std::string_view key,
                     int64_t unix_time_milliseconds,
                     uint64_t flags = 0) override;
-  int64_t PExpireAt(Status& status, size_t db, const std::string& key,
+  int64_t PExpireAt(Status& status, size_t db, std::string_view key,
                     int64_t unix_time_milliseconds,
                     uint64_t flags = 0) override;
 
-  int64_t PExpireTime(const std::string& key) override;
-  int64_t PExpireTime(size_t db, const std::string& key) override;
-  int64_t PExpireTime(Status& status, const std::string& key) override;
-  int64_t PExpireTime(Status& status, size_t db,
-                      const std::string& key) override;
+  int64_t PExpireTime(std::string_view key) override;
+  int64_t PExpireTime(size_t db, std::string_view key) override;
+  int64_t PExpireTime(Status& status, std::string_view key) override;
+  int64_t PExpireTime(Status& status, size_t db, std::string_view key) override;
 
-  int64_t Pttl(const std::string& key) override;
-  int64_t Pttl(size_t db, const std::string& key) override;
-  int64_t Pttl(Status& status, const std::string& key) override;
-  int64_t Pttl(Status& status, size_t db, const std::string& key) override;
+  int64_t Pttl(std::string_view key) override;
+  int64_t Pttl(size_t db, std::string_view key) override;
+  int64_t Pttl(Status& status, std::string_view key) override;
+  int64_t Pttl(Status& status, size_t db, std::string_view key) override;
 
   int64_t Touch(const std::vector<std::string>& keys) override;
   int64_t Touch(size_t db, const std::vector<std::string>& keys) override;
@@ -109,78 +146,169 @@ class CacheImpl : public Cache {
   int64_t Touch(Status& status, size_t db,
                 const std::vector<std::string>& keys) override;
 
-  int64_t Ttl(const std::string& key) override;
-  int64_t Ttl(size_t db, const std::string& key) override;
-  int64_t Ttl(Status& status, const std::string& key) override;
-  int64_t Ttl(Status& status, size_t db, const std::string& key) override;
+  int64_t Ttl(std::string_view key) override;
+  int64_t Ttl(size_t db, std::string_view key) override;
+  int64_t Ttl(Status& status, std::string_view key) override;
+  int64_t Ttl(Status& status, size_t db, std::string_view key) override;
 
-  enum Type Type(const std::string& key) override;
-  enum Type Type(size_t db, const std::string& key) override;
-  enum Type Type(Status& status, const std::string& key) override;
-  enum Type Type(Status& status, size_t db, const std::string& key) override;
+  enum Type Type(std::string_view key) override;
+  enum Type Type(size_t db, std::string_view key) override;
+  enum Type Type(Status& status, std::string_view key) override;
+  enum Type Type(Status& status, size_t db, std::string_view key) override;
+
+  int64_t Unlink(const std::vector<std::string>& keys) override;
+  int64_t Unlink(size_t db, const std::vector<std::string>& keys) override;
+  int64_t Unlink(Status& status, const std::vector<std::string>& keys) override;
+  int64_t Unlink(Status& status, size_t db,
+                 const std::vector<std::string>& keys) override;
 
   // String 组
-  int64_t Append(const std::string& key, const std::string& value) override;
-  int64_t Append(size_t db, const std::string& key,
+  int64_t Append(std::string_view key, const std::string& value) override;
+  int64_t Append(size_t db, std::string_view key,
                  const std::string& value) override;
-  int64_t Append(Status& status, const std::string& key,
+  int64_t Append(Status& status, std::string_view key,
                  const std::string& value) override;
-  int64_t Append(Status& status, size_t db, const std::string& key,
+  int64_t Append(Status& status, size_t db, std::string_view key,
                  const std::string& value) override;
+  int64_t Append(std::string_view key, std::string&& value) override;
+  int64_t Append(size_t db, std::string_view key, std::string&& value) override;
+  int64_t Append(Status& status, std::string_view key,
+                 std::string&& value) override;
+  int64_t Append(Status& status, size_t db, std::string_view key,
+                 std::string&& value) override;
 
-  int64_t Decr(const std::string& key) override;
-  int64_t Decr(size_t db, const std::string& key) override;
-  int64_t Decr(Status& status, const std::string& key) override;
-  int64_t Decr(Status& status, size_t db, const std::string& key) override;
+  int64_t Decr(std::string_view key) override;
+  int64_t Decr(size_t db, std::string_view key) override;
+  int64_t Decr(Status& status, std::string_view key) override;
+  int64_t Decr(Status& status, size_t db, std::string_view key) override;
 
-  int64_t DecrBy(const std::string& key, int64_t decrement) override;
-  int64_t DecrBy(size_t db, const std::string& key, int64_t decrement) override;
-  int64_t DecrBy(Status& status, const std::string& key,
+  int64_t DecrBy(std::string_view key, int64_t decrement) override;
+  int64_t DecrBy(size_t db, std::string_view key, int64_t decrement) override;
+  int64_t DecrBy(Status& status, std::string_view key,
                  int64_t decrement) override;
-  int64_t DecrBy(Status& status, size_t db, const std::string& key,
+  int64_t DecrBy(Status& status, size_t db, std::string_view key,
                  int64_t decrement) override;
 
-  int64_t Incr(const std::string& key) override;
-  int64_t Incr(size_t db, const std::string& key) override;
-  int64_t Incr(Status& status, const std::string& key) override;
-  int64_t Incr(Status& status, size_t db, const std::string& key) override;
+  int64_t Incr(std::string_view key) override;
+  int64_t Incr(size_t db, std::string_view key) override;
+  int64_t Incr(Status& status, std::string_view key) override;
+  int64_t Incr(Status& status, size_t db, std::string_view key) override;
 
-  int64_t IncrBy(const std::string& key, int64_t increment) override;
-  int64_t IncrBy(size_t db, const std::string& key, int64_t increment) override;
-  int64_t IncrBy(Status& status, const std::string& key,
+  int64_t IncrBy(std::string_view key, int64_t increment) override;
+  int64_t IncrBy(size_t db, std::string_view key, int64_t increment) override;
+  int64_t IncrBy(Status& status, std::string_view key,
                  int64_t increment) override;
-  int64_t IncrBy(Status& status, size_t db, const std::string& key,
+  int64_t IncrBy(Status& status, size_t db, std::string_view key,
                  int64_t increment) override;
 
-  std::optional<std::string> Get(const std::string& key) override;
-  std::optional<std::string> Get(size_t db, const std::string& key) override;
-  std::optional<std::string> Get(Status& status,
-                                 const std::string& key) override;
+  std::optional<std::string> Get(std::string_view key) override;
+  std::optional<std::string> Get(size_t db, std::string_view key) override;
+  std::optional<std::string> Get(Status& status, std::string_view key) override;
   std::optional<std::string> Get(Status& status, size_t db,
-                                 const std::string& key) override;
+                                 std::string_view key) override;
+
+  ValueRef GetRef(std::string_view key) override;
+  ValueRef GetRef(size_t db, std::string_view key) override;
+  ValueRef GetRef(Status& status, std::string_view key) override;
+  ValueRef GetRef(Status& status, size_t db, std::string_view key) override;
+
+  std::vector<std::optional<std::string>> MGet(
+      const std::vector<std::string>& keys) override;
+  std::vector<std::optional<std::string>> MGet(
+      size_t db, const std::vector<std::string>& keys) override;
+  std::vector<std::optional<std::string>> MGet(
+      Status& status, const std::vector<std::string>& keys) override;
+  std::vector<std::optional<std::string>> MGet(
+      Status& status, size_t db, const std::vector<std::string>& keys) override;
+
+  void MSet(
+      const std::vector<std::pair<std::string, std::string>>& kvs) override;
+  void MSet(
+      size_t db,
+      const std::vector<std::pair<std::string, std::string>>& kvs) override;
+  void MSet(
+      Status& status,
+      const std::vector<std::pair<std::string, std::string>>& kvs) override;
+  void MSet(
+      Status& status, size_t db,
+      const std::vector<std::pair<std::string, std::string>>& kvs) override;
+
+  int64_t MSetNX(
+      const std::vector<std::pair<std::string, std::string>>& kvs) override;
+  int64_t MSetNX(
+      size_t db,
+      const std::vector<std::pair<std::string, std::string>>& kvs) override;
+  int64_t MSetNX(
+      Status& status,
+      const std::vector<std::pair<std::string, std::string>>& kvs) override;
+  int64_t MSetNX(
+      Status& status, size_t db,
+      const std::vector<std::pair<std::string, std::string>>& kvs) override;
 
   std::optional<std::string> Set(
-      const std::string& key, const std::string& value, uint64_t flags = 0,
+      std::string_view key, const std::string& value, uint64_t flags = 0,
       const Expiration& expiration = NO_EXPIRE) override;
   std::optional<std::string> Set(
-      size_t db, const std::string& key, const std::string& value,
+      size_t db, std::string_view key, const std::string& value,
       uint64_t flags = 0, const Expiration& expiration = NO_EXPIRE) override;
   std::optional<std::string> Set(
-      Status& status, const std::string& key, const std::string& value,
+      Status& status, std::string_view key, const std::string& value,
       uint64_t flags = 0, const Expiration& expiration = NO_EXPIRE) override;
   std::optional<std::string> Set(
-      Status& status, size_t db, const std::string& key,
+      Status& status, size_t db, std::string_view key,
       const std::string& value, uint64_t flags = 0,
       const Expiration& expiration = NO_EXPIRE) override;
+  std::optional<std::string> Set(
+      std::string_view key, std::string&& value, uint64_t flags = 0,
+      const Expiration& expiration = NO_EXPIRE) override;
+  std::optional<std::string> Set(
+      size_t db, std::string_view key, std::string&& value, uint64_t flags = 0,
+      const Expiration& expiration = NO_EXPIRE) override;
+  std::optional<std::string> Set(
+      Status& status, std::string_view key, std::string&& value,
+      uint64_t flags = 0, const Expiration& expiration = NO_EXPIRE) override;
+  std::optional<std::string> Set(
+      Status& status, size_t db, std::string_view key, std::string&& value,
+      uint64_t flags = 0, const Expiration& expiration = NO_EXPIRE) override;
+
+  int64_t Update(std::string_view key, const UpdateFn& fn,
+                 const Expiration& expiration = NO_EXPIRE) override;
+  int64_t Update(size_t db, std::string_view key, const UpdateFn& fn,
+                 const Expiration& expiration = NO_EXPIRE) override;
+  int64_t Update(Status& status, std::string_view key, const UpdateFn& fn,
+                 const Expiration& expiration = NO_EXPIRE) override;
+  int64_t Update(Status& status, size_t db, std::string_view key,
+                 const UpdateFn& fn,
+                 const Expiration& expiration = NO_EXPIRE) override;
+
+  void Watch(Batch& batch, const std::vector<std::string>& keys) override;
+  void Watch(size_t db, Batch& batch,
+             const std::vector<std::string>& keys) override;
+  void Watch(Status& status, Batch& batch,
+             const std::vector<std::string>& keys) override;
+  void Watch(Status& status, size_t db, Batch& batch,
+             const std::vector<std::string>& keys) override;
+
+  std::optional<std::vector<BatchResult>> Exec(const Batch& batch) override;
+  std::optional<std::vector<BatchResult>> Exec(size_t db,
+                                               const Batch& batch) override;
+  std::optional<std::vector<BatchResult>> Exec(Status& status,
+                                               const Batch& batch) override;
+  std::optional<std::vector<BatchResult>> Exec(Status& status, size_t db,
+                                               const Batch& batch) override;
 
  private:
   CacheImpl(const Options& options);
   void TimerCallback() {
     for (auto& db : dbs_) {
-      db->CleanUpExpired();
+      db->ActiveExpireCycle();
+      db->ActiveEvictCycle();
     }
   }
 
+  // 先于 dbs_ 构造、后于 dbs_ 析构。
+  db::LazyFree lazy_free_;
+  db::MemoryCounter memory_;
   std::vector<std::unique_ptr<db::DB>> dbs_;
   size_t current_db_ = 0;
   expire::Timer timer;
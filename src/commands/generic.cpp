@@ -2,15 +2,65 @@
 
 using std::optional;
 using std::string;
+using std::string_view;
 using std::vector;
 
 namespace libcache {
 
-int64_t CacheImpl::Expire(const string& key, int64_t seconds, uint64_t flags) {
+int64_t CacheImpl::Del(const vector<string>& keys) {
+  return Del(current_db_, keys);
+}
+
+int64_t CacheImpl::Del(size_t db, const vector<string>& keys) {
+  auto status = Status::OK();
+  auto result = Del(status, db, keys);
+  status.ThrowIfError();
+  return result;
+}
+
+int64_t CacheImpl::Del(Status& status, const vector<string>& keys) {
+  return Del(status, current_db_, keys);
+}
+
+int64_t CacheImpl::Del(Status& status, size_t db, const vector<string>& keys) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return INT64_MIN;
+  }
+  return dbs_[db]->Del(keys);
+}
+
+int64_t CacheImpl::Exists(const vector<string>& keys) {
+  return Exists(current_db_, keys);
+}
+
+int64_t CacheImpl::Exists(size_t db, const vector<string>& keys) {
+  auto status = Status::OK();
+  auto result = Exists(status, db, keys);
+  status.ThrowIfError();
+  return result;
+}
+
+int64_t CacheImpl::Exists(Status& status, const vector<string>& keys) {
+  return Exists(status, current_db_, keys);
+}
+
+int64_t CacheImpl::Exists(Status& status, size_t db,
+                          const vector<string>& keys) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return INT64_MIN;
+  }
+  return dbs_[db]->Exists(keys);
+}
+
+int64_t CacheImpl::Expire(string_view key, int64_t seconds, uint64_t flags) {
   return Expire(current_db_, key, seconds, flags);
 }
 
-int64_t CacheImpl::Expire(size_t db, const string& key, int64_t seconds,
+int64_t CacheImpl::Expire(size_t db, string_view key, int64_t seconds,
                           uint64_t flags) {
   auto status = Status::OK();
   auto result = Expire(status, db, key, seconds, flags);
@@ -18,22 +68,22 @@ int64_t CacheImpl::Expire(size_t db, const string& key, int64_t seconds,
   return result;
 }
 
-int64_t CacheImpl::Expire(Status& status, const string& key, int64_t seconds,
+int64_t CacheImpl::Expire(Status& status, string_view key, int64_t seconds,
                           uint64_t flags) {
   return Expire(status, current_db_, key, seconds, flags);
 }
 
-int64_t CacheImpl::Expire(Status& status, size_t db, const string& key,
+int64_t CacheImpl::Expire(Status& status, size_t db, string_view key,
                           int64_t seconds, uint64_t flags) {
   return PExpire(status, db, key, seconds * 1000);
 }
 
-int64_t CacheImpl::ExpireAt(const string& key, int64_t unix_time_seconds,
+int64_t CacheImpl::ExpireAt(string_view key, int64_t unix_time_seconds,
                             uint64_t flags) {
   return ExpireAt(current_db_, key, unix_time_seconds, flags);
 }
 
-int64_t CacheImpl::ExpireAt(size_t db, const string& key,
+int64_t CacheImpl::ExpireAt(size_t db, string_view key,
                             int64_t unix_time_seconds, uint64_t flags) {
   auto status = Status::OK();
   auto result = ExpireAt(status, db, key, unix_time_seconds, flags);
@@ -41,32 +91,32 @@ int64_t CacheImpl::ExpireAt(size_t db, const string& key,
   return result;
 }
 
-int64_t CacheImpl::ExpireAt(Status& status, const string& key,
+int64_t CacheImpl::ExpireAt(Status& status, string_view key,
                             int64_t unix_time_seconds, uint64_t flags) {
   return ExpireAt(status, current_db_, key, unix_time_seconds, flags);
 }
 
-int64_t CacheImpl::ExpireAt(Status& status, size_t db, const string& key,
+int64_t CacheImpl::ExpireAt(Status& status, size_t db, string_view key,
                             int64_t unix_time_seconds, uint64_t flags) {
   return PExpireAt(status, db, key, unix_time_seconds * 1000, flags);
 }
 
-int64_t CacheImpl::ExpireTime(const string& key) {
+int64_t CacheImpl::ExpireTime(string_view key) {
   return ExpireTime(current_db_, key);
 }
 
-int64_t CacheImpl::ExpireTime(size_t db, const string& key) {
+int64_t CacheImpl::ExpireTime(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = ExpireTime(status, db, key);
   status.ThrowIfError();
   return result;
 }
 
-int64_t CacheImpl::ExpireTime(Status& status, const string& key) {
+int64_t CacheImpl::ExpireTime(Status& status, string_view key) {
   return ExpireTime(status, current_db_, key);
 }
 
-int64_t CacheImpl::ExpireTime(Status& status, size_t db, const string& key) {
+int64_t CacheImpl::ExpireTime(Status& status, size_t db, string_view key) {
   auto result = PExpireTime(status, db, key);
   status.ThrowIfError();
   if (result < 0) {
@@ -75,24 +125,23 @@ int64_t CacheImpl::ExpireTime(Status& status, size_t db, const string& key) {
   return result / 1000;
 }
 
-optional<Encoding> CacheImpl::ObjectEncoding(const string& key) {
+optional<Encoding> CacheImpl::ObjectEncoding(string_view key) {
   return ObjectEncoding(current_db_, key);
 }
 
-optional<Encoding> CacheImpl::ObjectEncoding(size_t db, const string& key) {
+optional<Encoding> CacheImpl::ObjectEncoding(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = ObjectEncoding(status, db, key);
   status.ThrowIfError();
   return result;
 }
 
-optional<Encoding> CacheImpl::ObjectEncoding(Status& status,
-                                             const string& key) {
+optional<Encoding> CacheImpl::ObjectEncoding(Status& status, string_view key) {
   return ObjectEncoding(status, current_db_, key);
 }
 
 optional<Encoding> CacheImpl::ObjectEncoding(Status& status, size_t db,
-                                             const string& key) {
+                                             string_view key) {
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
     return {};
@@ -100,23 +149,48 @@ optional<Encoding> CacheImpl::ObjectEncoding(Status& status, size_t db,
   return dbs_[db]->ObjectEncoding(key);
 }
 
-optional<int64_t> CacheImpl::ObjectIdleTime(const string& key) {
+optional<int64_t> CacheImpl::ObjectFreq(string_view key) {
+  return ObjectFreq(current_db_, key);
+}
+
+optional<int64_t> CacheImpl::ObjectFreq(size_t db, string_view key) {
+  auto status = Status::OK();
+  auto result = ObjectFreq(status, db, key);
+  status.ThrowIfError();
+  return result;
+}
+
+optional<int64_t> CacheImpl::ObjectFreq(Status& status, string_view key) {
+  return ObjectFreq(status, current_db_, key);
+}
+
+optional<int64_t> CacheImpl::ObjectFreq(Status& status, size_t db,
+                                        string_view key) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return {};
+  }
+  return dbs_[db]->ObjectFreq(status, key);
+}
+
+optional<int64_t> CacheImpl::ObjectIdleTime(string_view key) {
   return ObjectIdleTime(current_db_, key);
 }
 
-optional<int64_t> CacheImpl::ObjectIdleTime(size_t db, const string& key) {
+optional<int64_t> CacheImpl::ObjectIdleTime(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = ObjectIdleTime(status, db, key);
   status.ThrowIfError();
   return result;
 }
 
-optional<int64_t> CacheImpl::ObjectIdleTime(Status& status, const string& key) {
+optional<int64_t> CacheImpl::ObjectIdleTime(Status& status, string_view key) {
   return ObjectIdleTime(status, current_db_, key);
 }
 
 optional<int64_t> CacheImpl::ObjectIdleTime(Status& status, size_t db,
-                                            const string& key) {
+                                            string_view key) {
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
     return INT64_MIN;
@@ -124,22 +198,22 @@ optional<int64_t> CacheImpl::ObjectIdleTime(Status& status, size_t db,
   return dbs_[db]->ObjectIdletime(key);
 }
 
-int64_t CacheImpl::Persist(const string& key) {
+int64_t CacheImpl::Persist(string_view key) {
   return Persist(current_db_, key);
 }
 
-int64_t CacheImpl::Persist(size_t db, const string& key) {
+int64_t CacheImpl::Persist(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = Persist(status, db, key);
   status.ThrowIfError();
   return result;
 }
 
-int64_t CacheImpl::Persist(Status& status, const string& key) {
+int64_t CacheImpl::Persist(Status& status, string_view key) {
   return Persist(status, current_db_, key);
 }
 
-int64_t CacheImpl::Persist(Status& status, size_t db, const string& key) {
+int64_t CacheImpl::Persist(Status& status, size_t db, string_view key) {
   status = Status::OK();
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
@@ -148,12 +222,12 @@ int64_t CacheImpl::Persist(Status& status, size_t db, const string& key) {
   return dbs_[db]->Persist(key);
 }
 
-int64_t CacheImpl::PExpire(const string& key, int64_t milliseconds,
+int64_t CacheImpl::PExpire(string_view key, int64_t milliseconds,
                            uint64_t flags) {
   return PExpire(current_db_, key, milliseconds, flags);
 }
 
-int64_t CacheImpl::PExpire(size_t db, const string& key, int64_t milliseconds,
+int64_t CacheImpl::PExpire(size_t db, string_view key, int64_t milliseconds,
                            uint64_t flags) {
   auto status = Status::OK();
   auto result = PExpire(status, db, key, milliseconds, flags);
@@ -161,12 +235,12 @@ int64_t CacheImpl::PExpire(size_t db, const string& key, int64_t milliseconds,
   return result;
 }
 
-int64_t CacheImpl::PExpire(Status& status, const string& key,
+int64_t CacheImpl::PExpire(Status& status, string_view key,
                            int64_t milliseconds, uint64_t flags) {
   return PExpire(status, current_db_, key, milliseconds, flags);
 }
 
-int64_t CacheImpl::PExpire(Status& status, size_t db, const string& key,
+int64_t CacheImpl::PExpire(Status& status, size_t db, string_view key,
                            int64_t milliseconds, uint64_t flags) {
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
@@ -175,12 +249,12 @@ int64_t CacheImpl::PExpire(Status& status, size_t db, const string& key,
   return dbs_[db]->PExpire(status, key, milliseconds, flags);
 }
 
-int64_t CacheImpl::PExpireAt(const string& key, int64_t unix_time_milliseconds,
+int64_t CacheImpl::PExpireAt(string_view key, int64_t unix_time_milliseconds,
                              uint64_t flags) {
   return PExpireAt(current_db_, key, unix_time_milliseconds, flags);
 }
 
-int64_t CacheImpl::PExpireAt(size_t db, const string& key,
+int64_t CacheImpl::PExpireAt(size_t db, string_view key,
                              int64_t unix_time_milliseconds, uint64_t flags) {
   auto status = Status::OK();
   auto result = PExpireAt(status, db, key, unix_time_milliseconds, flags);
@@ -188,12 +262,12 @@ int64_t CacheImpl::PExpireAt(size_t db, const string& key,
   return result;
 }
 
-int64_t CacheImpl::PExpireAt(Status& status, const string& key,
+int64_t CacheImpl::PExpireAt(Status& status, string_view key,
                              int64_t unix_time_milliseconds, uint64_t flags) {
   return PExpireAt(status, current_db_, key, unix_time_milliseconds, flags);
 }
 
-int64_t CacheImpl::PExpireAt(Status& status, size_t db, const string& key,
+int64_t CacheImpl::PExpireAt(Status& status, size_t db, string_view key,
                              int64_t unix_time_milliseconds, uint64_t flags) {
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
@@ -202,22 +276,22 @@ int64_t CacheImpl::PExpireAt(Status& status, size_t db, const string& key,
   return dbs_[db]->PExpireAt(status, key, unix_time_milliseconds, flags);
 }
 
-int64_t CacheImpl::PExpireTime(const string& key) {
+int64_t CacheImpl::PExpireTime(string_view key) {
   return PExpireTime(current_db_, key);
 }
 
-int64_t CacheImpl::PExpireTime(size_t db, const string& key) {
+int64_t CacheImpl::PExpireTime(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = PExpireTime(status, db, key);
   status.ThrowIfError();
   return result;
 }
 
-int64_t CacheImpl::PExpireTime(Status& status, const string& key) {
+int64_t CacheImpl::PExpireTime(Status& status, string_view key) {
   return PExpireTime(status, current_db_, key);
 }
 
-int64_t CacheImpl::PExpireTime(Status& status, size_t db, const string& key) {
+int64_t CacheImpl::PExpireTime(Status& status, size_t db, string_view key) {
   status = Status::OK();
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
@@ -226,20 +300,20 @@ int64_t CacheImpl::PExpireTime(Status& status, size_t db, const string& key) {
   return dbs_[db]->PExpireTime(key);
 }
 
-int64_t CacheImpl::Pttl(const string& key) { return Pttl(current_db_, key); }
+int64_t CacheImpl::Pttl(string_view key) { return Pttl(current_db_, key); }
 
-int64_t CacheImpl::Pttl(size_t db, const string& key) {
+int64_t CacheImpl::Pttl(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = Pttl(status, db, key);
   status.ThrowIfError();
   return result;
 }
 
-int64_t CacheImpl::Pttl(Status& status, const string& key) {
+int64_t CacheImpl::Pttl(Status& status, string_view key) {
   return Pttl(status, current_db_, key);
 }
 
-int64_t CacheImpl::Pttl(Status& status, size_t db, const string& key) {
+int64_t CacheImpl::Pttl(Status& status, size_t db, string_view key) {
   status = Status::OK();
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
@@ -273,20 +347,20 @@ int64_t CacheImpl::Touch(Status& status, size_t db,
   return dbs_[db]->Touch(keys);
 }
 
-int64_t CacheImpl::Ttl(const string& key) { return Ttl(current_db_, key); }
+int64_t CacheImpl::Ttl(string_view key) { return Ttl(current_db_, key); }
 
-int64_t CacheImpl::Ttl(size_t db, const string& key) {
+int64_t CacheImpl::Ttl(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = Ttl(status, db, key);
   status.ThrowIfError();
   return result;
 }
 
-int64_t CacheImpl::Ttl(Status& status, const string& key) {
+int64_t CacheImpl::Ttl(Status& status, string_view key) {
   return Ttl(status, current_db_, key);
 }
 
-int64_t CacheImpl::Ttl(Status& status, size_t db, const string& key) {
+int64_t CacheImpl::Ttl(Status& status, size_t db, string_view key) {
   auto result = Pttl(status, db, key);
   status.ThrowIfError();
   if (result < 0) {
@@ -295,20 +369,20 @@ int64_t CacheImpl::Ttl(Status& status, size_t db, const string& key) {
   return result / 1000;
 }
 
-enum Type CacheImpl::Type(const string& key) { return Type(current_db_, key); }
+enum Type CacheImpl::Type(string_view key) { return Type(current_db_, key); }
 
-enum Type CacheImpl::Type(size_t db, const string& key) {
+enum Type CacheImpl::Type(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = Type(status, current_db_, key);
   status.ThrowIfError();
   return result;
 }
 
-enum Type CacheImpl::Type(Status& status, const string& key) {
+enum Type CacheImpl::Type(Status& status, string_view key) {
   return Type(status, current_db_, key);
 }
 
-enum Type CacheImpl::Type(Status& status, size_t db, const string& key) {
+enum Type CacheImpl::Type(Status& status, size_t db, string_view key) {
   status = Status::OK();
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
@@ -317,4 +391,29 @@ enum Type CacheImpl::Type(Status& status, size_t db, const string& key) {
   return dbs_[db]->Type(key);
 }
 
+int64_t CacheImpl::Unlink(const vector<string>& keys) {
+  return Unlink(current_db_, keys);
+}
+
+int64_t CacheImpl::Unlink(size_t db, const vector<string>& keys) {
+  auto status = Status::OK();
+  auto result = Unlink(status, db, keys);
+  status.ThrowIfError();
+  return result;
+}
+
+int64_t CacheImpl::Unlink(Status& status, const vector<string>& keys) {
+  return Unlink(status, current_db_, keys);
+}
+
+int64_t CacheImpl::Unlink(Status& status, size_t db,
+                          const vector<string>& keys) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return INT64_MIN;
+  }
+  return dbs_[db]->Unlink(keys);
+}
+
 }  // namespace libcache
@@ -1,27 +1,31 @@
 #include "cache_impl.hpp"
 
+using std::move;
 using std::optional;
+using std::pair;
 using std::string;
+using std::string_view;
+using std::vector;
 
 namespace libcache {
 
-int64_t CacheImpl::Append(const string& key, const string& value) {
+int64_t CacheImpl::Append(string_view key, const string& value) {
   return Append(current_db_, key, value);
 }
 
-int64_t CacheImpl::Append(size_t db, const string& key, const string& value) {
+int64_t CacheImpl::Append(size_t db, string_view key, const string& value) {
   auto status = Status::OK();
   auto result = Append(status, db, key, value);
   status.ThrowIfError();
   return result;
 }
 
-int64_t CacheImpl::Append(Status& status, const string& key,
+int64_t CacheImpl::Append(Status& status, string_view key,
                           const string& value) {
   return Append(status, current_db_, key, value);
 }
 
-int64_t CacheImpl::Append(Status& status, size_t db, const string& key,
+int64_t CacheImpl::Append(Status& status, size_t db, string_view key,
                           const string& value) {
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
@@ -30,40 +34,63 @@ int64_t CacheImpl::Append(Status& status, size_t db, const string& key,
   return dbs_[db]->Append(status, key, value);
 }
 
-int64_t CacheImpl::Decr(const string& key) { return Decr(current_db_, key); }
+int64_t CacheImpl::Append(string_view key, string&& value) {
+  return Append(current_db_, key, move(value));
+}
+
+int64_t CacheImpl::Append(size_t db, string_view key, string&& value) {
+  auto status = Status::OK();
+  auto result = Append(status, db, key, move(value));
+  status.ThrowIfError();
+  return result;
+}
+
+int64_t CacheImpl::Append(Status& status, string_view key, string&& value) {
+  return Append(status, current_db_, key, move(value));
+}
+
+int64_t CacheImpl::Append(Status& status, size_t db, string_view key,
+                          string&& value) {
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return {};
+  }
+  return dbs_[db]->Append(status, key, move(value));
+}
 
-int64_t CacheImpl::Decr(size_t db, const string& key) {
+int64_t CacheImpl::Decr(string_view key) { return Decr(current_db_, key); }
+
+int64_t CacheImpl::Decr(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = CacheImpl::Decr(status, db, key);
   status.ThrowIfError();
   return result;
 }
 
-int64_t CacheImpl::Decr(Status& status, const string& key) {
+int64_t CacheImpl::Decr(Status& status, string_view key) {
   return Decr(status, current_db_, key);
 }
 
-int64_t CacheImpl::Decr(Status& status, size_t db, const string& key) {
+int64_t CacheImpl::Decr(Status& status, size_t db, string_view key) {
   return DecrBy(status, db, key, 1);
 }
 
-int64_t CacheImpl::DecrBy(const string& key, int64_t decrement) {
+int64_t CacheImpl::DecrBy(string_view key, int64_t decrement) {
   return DecrBy(current_db_, key, decrement);
 }
 
-int64_t CacheImpl::DecrBy(size_t db, const string& key, int64_t decrement) {
+int64_t CacheImpl::DecrBy(size_t db, string_view key, int64_t decrement) {
   auto status = Status::OK();
   auto result = CacheImpl::DecrBy(status, db, key, decrement);
   status.ThrowIfError();
   return result;
 }
 
-int64_t CacheImpl::DecrBy(Status& status, const string& key,
-                          int64_t decrement) {
+int64_t CacheImpl::DecrBy(Status& status, string_view key, int64_t decrement) {
   return DecrBy(status, current_db_, key, decrement);
 }
 
-int64_t CacheImpl::DecrBy(Status& status, size_t db, const string& key,
+int64_t CacheImpl::DecrBy(Status& status, size_t db, string_view key,
                           int64_t decrement) {
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
@@ -72,40 +99,39 @@ int64_t CacheImpl::DecrBy(Status& status, size_t db, const string& key,
   return dbs_[db]->DecrBy(status, key, decrement);
 }
 
-int64_t CacheImpl::Incr(const string& key) { return Incr(current_db_, key); }
+int64_t CacheImpl::Incr(string_view key) { return Incr(current_db_, key); }
 
-int64_t CacheImpl::Incr(size_t db, const string& key) {
+int64_t CacheImpl::Incr(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = CacheImpl::Incr(status, db, key);
   status.ThrowIfError();
   return result;
 }
 
-int64_t CacheImpl::Incr(Status& status, const string& key) {
+int64_t CacheImpl::Incr(Status& status, string_view key) {
   return Incr(status, current_db_, key);
 }
 
-int64_t CacheImpl::Incr(Status& status, size_t db, const string& key) {
+int64_t CacheImpl::Incr(Status& status, size_t db, string_view key) {
   return IncrBy(status, db, key, 1);
 }
 
-int64_t CacheImpl::IncrBy(const string& key, int64_t decrement) {
+int64_t CacheImpl::IncrBy(string_view key, int64_t decrement) {
   return IncrBy(current_db_, key, decrement);
 }
 
-int64_t CacheImpl::IncrBy(size_t db, const string& key, int64_t decrement) {
+int64_t CacheImpl::IncrBy(size_t db, string_view key, int64_t decrement) {
   auto status = Status::OK();
   auto result = CacheImpl::IncrBy(status, db, key, decrement);
   status.ThrowIfError();
   return result;
 }
 
-int64_t CacheImpl::IncrBy(Status& status, const string& key,
-                          int64_t decrement) {
+int64_t CacheImpl::IncrBy(Status& status, string_view key, int64_t decrement) {
   return IncrBy(status, current_db_, key, decrement);
 }
 
-int64_t CacheImpl::IncrBy(Status& status, size_t db, const string& key,
+int64_t CacheImpl::IncrBy(Status& status, size_t db, string_view key,
                           int64_t increment) {
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
@@ -114,22 +140,22 @@ int64_t CacheImpl::IncrBy(Status& status, size_t db, const string& key,
   return dbs_[db]->IncrBy(status, key, increment);
 }
 
-optional<string> CacheImpl::Get(const string& key) {
+optional<string> CacheImpl::Get(string_view key) {
   return Get(current_db_, key);
 }
 
-optional<string> CacheImpl::Get(size_t db, const string& key) {
+optional<string> CacheImpl::Get(size_t db, string_view key) {
   auto status = Status::OK();
   auto result = Get(status, db, key);
   status.ThrowIfError();
   return result;
 }
 
-optional<string> CacheImpl::Get(Status& status, const string& key) {
+optional<string> CacheImpl::Get(Status& status, string_view key) {
   return Get(status, current_db_, key);
 }
 
-optional<string> CacheImpl::Get(Status& status, size_t db, const string& key) {
+optional<string> CacheImpl::Get(Status& status, size_t db, string_view key) {
   if (db >= dbs_.size()) {
     status = Status::DBIndexOutOfRange();
     return {};
@@ -137,27 +163,126 @@ optional<string> CacheImpl::Get(Status& status, size_t db, const string& key) {
   return dbs_[db]->Get(status, key);
 }
 
-optional<string> CacheImpl::Set(const string& key, const string& value,
+ValueRef CacheImpl::GetRef(string_view key) {
+  return GetRef(current_db_, key);
+}
+
+ValueRef CacheImpl::GetRef(size_t db, string_view key) {
+  auto status = Status::OK();
+  auto result = GetRef(status, db, key);
+  status.ThrowIfError();
+  return result;
+}
+
+ValueRef CacheImpl::GetRef(Status& status, string_view key) {
+  return GetRef(status, current_db_, key);
+}
+
+ValueRef CacheImpl::GetRef(Status& status, size_t db, string_view key) {
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return {};
+  }
+  return dbs_[db]->GetRef(status, key);
+}
+
+vector<optional<string>> CacheImpl::MGet(const vector<string>& keys) {
+  return MGet(current_db_, keys);
+}
+
+vector<optional<string>> CacheImpl::MGet(size_t db,
+                                         const vector<string>& keys) {
+  auto status = Status::OK();
+  auto result = MGet(status, db, keys);
+  status.ThrowIfError();
+  return result;
+}
+
+vector<optional<string>> CacheImpl::MGet(Status& status,
+                                         const vector<string>& keys) {
+  return MGet(status, current_db_, keys);
+}
+
+vector<optional<string>> CacheImpl::MGet(Status& status, size_t db,
+                                         const vector<string>& keys) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return {};
+  }
+  return dbs_[db]->MGet(keys);
+}
+
+void CacheImpl::MSet(const vector<pair<string, string>>& kvs) {
+  MSet(current_db_, kvs);
+}
+
+void CacheImpl::MSet(size_t db, const vector<pair<string, string>>& kvs) {
+  auto status = Status::OK();
+  MSet(status, db, kvs);
+  status.ThrowIfError();
+}
+
+void CacheImpl::MSet(Status& status, const vector<pair<string, string>>& kvs) {
+  MSet(status, current_db_, kvs);
+}
+
+void CacheImpl::MSet(Status& status, size_t db,
+                     const vector<pair<string, string>>& kvs) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return;
+  }
+  dbs_[db]->MSet(status, kvs);
+}
+
+int64_t CacheImpl::MSetNX(const vector<pair<string, string>>& kvs) {
+  return MSetNX(current_db_, kvs);
+}
+
+int64_t CacheImpl::MSetNX(size_t db, const vector<pair<string, string>>& kvs) {
+  auto status = Status::OK();
+  auto result = MSetNX(status, db, kvs);
+  status.ThrowIfError();
+  return result;
+}
+
+int64_t CacheImpl::MSetNX(Status& status,
+                          const vector<pair<string, string>>& kvs) {
+  return MSetNX(status, current_db_, kvs);
+}
+
+int64_t CacheImpl::MSetNX(Status& status, size_t db,
+                          const vector<pair<string, string>>& kvs) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return {};
+  }
+  return dbs_[db]->MSetNX(status, kvs);
+}
+
+optional<string> CacheImpl::Set(string_view key, const string& value,
                                 uint64_t flags, const Expiration& expiration) {
   return Set(current_db_, key, value, flags, expiration);
 }
 
-optional<string> CacheImpl::Set(size_t db, const string& key,
-                                const string& value, uint64_t flags,
-                                const Expiration& expiration) {
+optional<string> CacheImpl::Set(size_t db, string_view key, const string& value,
+                                uint64_t flags, const Expiration& expiration) {
   auto status = Status::OK();
   auto result = Set(status, db, key, value, flags, expiration);
   status.ThrowIfError();
   return result;
 }
 
-optional<string> CacheImpl::Set(Status& status, const string& key,
+optional<string> CacheImpl::Set(Status& status, string_view key,
                                 const string& value, uint64_t flags,
                                 const Expiration& expiration) {
   return Set(status, current_db_, key, value, flags, expiration);
 }
 
-optional<string> CacheImpl::Set(Status& status, size_t db, const string& key,
+optional<string> CacheImpl::Set(Status& status, size_t db, string_view key,
                                 const string& value, uint64_t flags,
                                 const Expiration& expiration) {
   if (db >= dbs_.size()) {
@@ -167,4 +292,59 @@ optional<string> CacheImpl::Set(Status& status, size_t db, const string& key,
   return dbs_[db]->Set(status, key, value, flags, expiration);
 }
 
+optional<string> CacheImpl::Set(string_view key, string&& value, uint64_t flags,
+                                const Expiration& expiration) {
+  return Set(current_db_, key, move(value), flags, expiration);
+}
+
+optional<string> CacheImpl::Set(size_t db, string_view key, string&& value,
+                                uint64_t flags, const Expiration& expiration) {
+  auto status = Status::OK();
+  auto result = Set(status, db, key, move(value), flags, expiration);
+  status.ThrowIfError();
+  return result;
+}
+
+optional<string> CacheImpl::Set(Status& status, string_view key, string&& value,
+                                uint64_t flags, const Expiration& expiration) {
+  return Set(status, current_db_, key, move(value), flags, expiration);
+}
+
+optional<string> CacheImpl::Set(Status& status, size_t db, string_view key,
+                                string&& value, uint64_t flags,
+                                const Expiration& expiration) {
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return {};
+  }
+  return dbs_[db]->Set(status, key, move(value), flags, expiration);
+}
+
+int64_t CacheImpl::Update(string_view key, const UpdateFn& fn,
+                          const Expiration& expiration) {
+  return Update(current_db_, key, fn, expiration);
+}
+
+int64_t CacheImpl::Update(size_t db, string_view key, const UpdateFn& fn,
+                          const Expiration& expiration) {
+  auto status = Status::OK();
+  auto result = Update(status, db, key, fn, expiration);
+  status.ThrowIfError();
+  return result;
+}
+
+int64_t CacheImpl::Update(Status& status, string_view key, const UpdateFn& fn,
+                          const Expiration& expiration) {
+  return Update(status, current_db_, key, fn, expiration);
+}
+
+int64_t CacheImpl::Update(Status& status, size_t db, string_view key,
+                          const UpdateFn& fn, const Expiration& expiration) {
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return {};
+  }
+  return dbs_[db]->Update(status, key, fn, expiration);
+}
+
 }  // namespace libcache
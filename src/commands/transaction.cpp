@@ -0,0 +1,69 @@
+#include "cache_impl.hpp"
+
+using std::optional;
+using std::string;
+using std::vector;
+
+namespace libcache {
+
+void CacheImpl::Watch(Batch& batch, const vector<string>& keys) {
+  Watch(current_db_, batch, keys);
+}
+
+void CacheImpl::Watch(size_t db, Batch& batch, const vector<string>& keys) {
+  auto status = Status::OK();
+  Watch(status, db, batch, keys);
+  status.ThrowIfError();
+}
+
+void CacheImpl::Watch(Status& status, Batch& batch,
+                      const vector<string>& keys) {
+  Watch(status, current_db_, batch, keys);
+}
+
+void CacheImpl::Watch(Status& status, size_t db, Batch& batch,
+                      const vector<string>& keys) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return;
+  }
+  auto versions = dbs_[db]->Versions(keys);
+  for (size_t i = 0; i < keys.size(); i++) {
+    batch.watches_.push_back({db, keys[i], versions[i]});
+  }
+}
+
+optional<vector<BatchResult>> CacheImpl::Exec(const Batch& batch) {
+  return Exec(current_db_, batch);
+}
+
+optional<vector<BatchResult>> CacheImpl::Exec(size_t db, const Batch& batch) {
+  auto status = Status::OK();
+  auto result = Exec(status, db, batch);
+  status.ThrowIfError();
+  return result;
+}
+
+optional<vector<BatchResult>> CacheImpl::Exec(Status& status,
+                                              const Batch& batch) {
+  return Exec(status, current_db_, batch);
+}
+
+optional<vector<BatchResult>> CacheImpl::Exec(Status& status, size_t db,
+                                              const Batch& batch) {
+  status = Status::OK();
+  if (db >= dbs_.size()) {
+    status = Status::DBIndexOutOfRange();
+    return {};
+  }
+  // 其他 db 的键不能和这个 db 一起加锁检查，按冲突处理。
+  for (const auto& watch : batch.watches_) {
+    if (watch.db != db) {
+      return {};
+    }
+  }
+  return dbs_[db]->Exec(batch);
+}
+
+}  // namespace libcache
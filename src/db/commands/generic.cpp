@@ -3,50 +3,138 @@
 #include "db/db.hpp"
 
 using std::lock_guard;
-using std::mutex;
 using std::optional;
+using std::shared_lock;
+using std::shared_mutex;
 using std::string;
+using std::string_view;
 using std::vector;
 
 namespace libcache::db {
 
-optional<Encoding> DB::ObjectEncoding(const string& key) const {
-  lock_guard<mutex> lock(mutex_);
+namespace {
 
-  auto obj = GetObject(key);
+int64_t PttlOf(const Object* obj) {
+  if (!obj) {
+    return -2;
+  }
+
+  if (!obj->HasExpire()) {
+    return -1;
+  }
+  return obj->pttl();
+}
+
+}  // namespace
+
+// 和 Unlink 不同，值在调用线程中释放。
+int64_t DB::Del(const vector<string>& keys) {
+  vector<size_t> hashes;
+  vector<size_t> indexes;
+  HashKeys(keys, hashes, indexes);
+  auto locks = LockShards(indexes);
+
+  int64_t count = 0;
+  ForEachKey(hashes, indexes, [&](Shard& shard, size_t i) {
+    count += shard.DelObject(keys[i], hashes[i], false);
+  });
+  return count;
+}
+
+// 重复的键重复计数。遇到的已过期的键在释放共享锁后删除。
+int64_t DB::Exists(const vector<string>& keys) const {
+  vector<size_t> hashes;
+  vector<size_t> indexes;
+  HashKeys(keys, hashes, indexes);
+
+  int64_t count = 0;
+  vector<size_t> expired;
+  {
+    auto locks = LockShardsShared(indexes);
+    ForEachKey(hashes, indexes, [&](Shard& shard, size_t i) {
+      bool is_expired = false;
+      count += shard.PeekObject(keys[i], hashes[i], is_expired) != nullptr;
+      if (is_expired) {
+        expired.push_back(i);
+      }
+    });
+  }
+  EraseExpired(keys, hashes, expired);
+  return count;
+}
+
+optional<Encoding> DB::ObjectEncoding(string_view key) const {
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  shared_lock<shared_mutex> lock(shard.mutex());
+
+  auto obj = shard.GetObject(key, hash, lock);
   if (!obj) {
     return {};
   }
   return obj->encoding();
 }
 
-optional<int64_t> DB::ObjectIdletime(const string& key) const {
-  lock_guard<mutex> lock(mutex_);
+// 和 Redis 的 OBJECT FREQ 一样，只有 LFU 策略下才记录访问频率。
+optional<int64_t> DB::ObjectFreq(Status& status, string_view key) const {
+  status = Status::OK();
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  if (!shard.lfu()) {
+    status = Status::NoLFUPolicy();
+    return {};
+  }
+  shared_lock<shared_mutex> lock(shard.mutex());
 
-  auto obj = GetObject(key);
+  auto obj = shard.GetObject(key, hash, lock);
   if (!obj) {
     return {};
   }
-  return obj->idletime() / 1000;
+  return shard.Freq(obj, shard.AccessTime());
 }
 
-int64_t DB::Persist(const string& key) const {
-  lock_guard<mutex> lock(mutex_);
+optional<int64_t> DB::ObjectIdletime(string_view key) const {
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  shared_lock<shared_mutex> lock(shard.mutex());
 
-  auto obj = GetObject(key);
+  auto obj = shard.GetObject(key, hash, lock);
+  if (!obj) {
+    return {};
+  }
+  return obj->idletime(shard.AccessTime()) / 1000;
+}
+
+int64_t DB::Persist(string_view key) const {
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
+  return PersistNoLock(shard, key, hash);
+}
+
+int64_t DB::PersistNoLock(Shard& shard, string_view key, size_t hash) const {
+  auto obj = shard.GetObject(key, hash);
   if (!obj) {
     return 0;
   }
-  obj->Touch();
+  shard.Touch(obj);
 
   if (obj->HasExpire()) {
-    obj->Persist();
+    shard.Persist(obj, hash);
   }
   return 1;
 }
 
-int64_t DB::PExpire(Status& status, const string& key, int64_t milliseconds,
+int64_t DB::PExpire(Status& status, string_view key, int64_t milliseconds,
                     uint64_t flags) {
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
+  return PExpireNoLock(status, shard, key, hash, milliseconds, flags);
+}
+
+int64_t DB::PExpireNoLock(Status& status, Shard& shard, string_view key,
+                          size_t hash, int64_t milliseconds, uint64_t flags) {
   status = Status::OK();
 
   flags &= NX | XX | GT | LT;
@@ -61,15 +149,14 @@ int64_t DB::PExpire(Status& status, const string& key, int64_t milliseconds,
     return INT64_MIN;
   }
 
-  lock_guard<mutex> lock(mutex_);
-  auto obj = GetObject(key);
+  auto obj = shard.GetObject(key, hash);
   if (!obj) {
     return 0;
   }
-  obj->Touch();
+  shard.Touch(obj);
 
-  int64_t pttl = obj->pttl();
   if (obj->HasExpire()) {
+    int64_t pttl = obj->pttl();
     if (flags & NX) {
       return 0;
     }
@@ -83,18 +170,18 @@ int64_t DB::PExpire(Status& status, const string& key, int64_t milliseconds,
         return 0;
       }
     }
-    obj->Px(milliseconds);
+    shard.Px(obj, hash, milliseconds);
     return 1;
   }
 
   if (flags & XX) {
     return 0;
   }
-  obj->Px(milliseconds);
+  shard.Px(obj, hash, milliseconds);
   return 1;
 }
 
-int64_t DB::PExpireAt(Status& status, const string& key,
+int64_t DB::PExpireAt(Status& status, string_view key,
                       int64_t unix_time_milliseconds, uint64_t flags) {
   status = Status::OK();
 
@@ -110,12 +197,14 @@ int64_t DB::PExpireAt(Status& status, const string& key,
     return INT64_MIN;
   }
 
-  lock_guard<mutex> lock(mutex_);
-  auto obj = GetObject(key);
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
+  auto obj = shard.GetObject(key, hash);
   if (!obj) {
     return 0;
   }
-  obj->Touch();
+  shard.Touch(obj);
 
   if (obj->HasExpire()) {
     if (flags & NX) {
@@ -131,21 +220,23 @@ int64_t DB::PExpireAt(Status& status, const string& key,
         return 0;
       }
     }
-    obj->Pxat(unix_time_milliseconds);
+    shard.Pxat(obj, hash, unix_time_milliseconds);
     return 1;
   }
 
   if (flags & XX) {
     return 0;
   }
-  obj->Pxat(unix_time_milliseconds);
+  shard.Pxat(obj, hash, unix_time_milliseconds);
   return 1;
 }
 
-int64_t DB::PExpireTime(const string& key) const {
-  lock_guard<mutex> lock(mutex_);
+int64_t DB::PExpireTime(string_view key) const {
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  shared_lock<shared_mutex> lock(shard.mutex());
 
-  auto obj = GetObject(key);
+  auto obj = shard.GetObject(key, hash, lock);
   if (!obj) {
     return -2;
   }
@@ -156,42 +247,58 @@ int64_t DB::PExpireTime(const string& key) const {
   return obj->expire_unix();
 }
 
-int64_t DB::Pttl(const string& key) const {
-  lock_guard<mutex> lock(mutex_);
-
-  auto obj = GetObject(key);
-  if (!obj) {
-    return -2;
-  }
+int64_t DB::Pttl(string_view key) const {
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  shared_lock<shared_mutex> lock(shard.mutex());
+  return PttlOf(shard.GetObject(key, hash, lock));
+}
 
-  if (!obj->HasExpire()) {
-    return -1;
-  }
-  return obj->pttl();
+int64_t DB::PttlNoLock(Shard& shard, string_view key, size_t hash) const {
+  return PttlOf(shard.GetObject(key, hash));
 }
 
 int64_t DB::Touch(const vector<string>& keys) {
-  lock_guard<mutex> lock(mutex_);
+  vector<size_t> hashes;
+  vector<size_t> indexes;
+  HashKeys(keys, hashes, indexes);
+  auto locks = LockShards(indexes);
 
   int64_t count = 0;
-  for (const auto& key : keys) {
-    auto obj = GetObject(key);
+  ForEachKey(hashes, indexes, [&](Shard& shard, size_t i) {
+    auto obj = shard.GetObject(keys[i], hashes[i]);
     if (obj) {
-      obj->Touch();
+      shard.Touch(obj);
       count++;
     }
-  }
+  });
   return count;
 }
 
-enum Type DB::Type(const string& key) const {
-  lock_guard<mutex> lock(mutex_);
+enum Type DB::Type(string_view key) const {
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  shared_lock<shared_mutex> lock(shard.mutex());
 
-  auto obj = GetObject(key);
+  auto obj = shard.GetObject(key, hash, lock);
   if (!obj) {
     return Type::kNone;
   }
   return obj->type();
 }
 
+// 值较大的对象交给后台线程释放，见 DBOptions::lazy_free_threshold。
+int64_t DB::Unlink(const vector<string>& keys) {
+  vector<size_t> hashes;
+  vector<size_t> indexes;
+  HashKeys(keys, hashes, indexes);
+  auto locks = LockShards(indexes);
+
+  int64_t count = 0;
+  ForEachKey(hashes, indexes, [&](Shard& shard, size_t i) {
+    count += shard.DelObject(keys[i], hashes[i]);
+  });
+  return count;
+}
+
 }  // namespace libcache::db
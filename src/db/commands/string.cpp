@@ -1,124 +1,367 @@
 #include "db/db.hpp"
 #include "db/string_object.hpp"
 
-using std::dynamic_pointer_cast;
+using std::forward;
 using std::lock_guard;
-using std::make_shared;
 using std::move;
-using std::mutex;
 using std::optional;
+using std::pair;
+using std::shared_lock;
+using std::shared_mutex;
 using std::string;
+using std::string_view;
 using std::to_string;
+using std::vector;
 
 namespace libcache::db {
 
-int64_t DB::Append(Status& status, const string& key, const string& value) {
-  status = Status::OK();
-  lock_guard<mutex> lock(mutex_);
+namespace {
+
+// 写时复制：共享的值不能原地修改，先换成独占的副本。
+StringObject* Unshare(Shard& shard, StringObject* obj, size_t hash) {
+  auto copy = ObjectPtr(obj->Unshare(shard.allocator()));
+  return static_cast<StringObject*>(shard.ReplaceObject(move(copy), hash));
+}
+
+// 写入字符串并清除原有的过期时间，需持有分片的独占锁。
+void PutString(Shard& shard, string_view key, size_t hash,
+               const string& value) {
+  auto obj = ObjectPtr(StringObject::New(shard.allocator(), key, value));
+  if (shard.GetObject(key, hash)) {
+    shard.ReplaceObject(move(obj), hash);
+  } else {
+    shard.PutObject(move(obj), hash);
+  }
+}
 
-  auto obj = GetObject(key);
+// 原地修改值时记下对象原来的大小，离开作用域时按差值记账，修改中途抛出异常
+// 也不会漏记。
+class MemoryGuard {
+ public:
+  MemoryGuard(Shard& shard, const Object* obj)
+      : shard_(shard), obj_(obj), usage_(obj->MemoryUsage()) {}
+  ~MemoryGuard() {
+    if (obj_) {
+      shard_.ChargeMemory(static_cast<int64_t>(obj_->MemoryUsage()) - usage_);
+    }
+  }
+  // 确认值没有改变，不再记账。
+  void Dismiss() { obj_ = nullptr; }
+
+ private:
+  Shard& shard_;
+  const Object* obj_;
+  int64_t usage_;
+};
+
+// Get 和 Exec 中的 Get 共用：更新访问时间并检查类型。
+optional<string> StringValue(Status& status, const Shard& shard, Object* obj) {
   if (!obj) {
-    auto str_obj = make_shared<StringObject>(key, expire_helper(), value);
-    PutObject(key, str_obj);
-    return value.size();
+    return {};
   }
-  obj->Touch();
+  shard.Touch(obj);
 
-  auto str_obj = dynamic_pointer_cast<StringObject>(obj);
-  auto& raw = str_obj->mut_raw();
-  raw.append(value);
-  return raw.size();
+  if (!obj->IsString()) {
+    status = Status::WrongType();
+    return {};
+  }
+
+  auto str_obj = static_cast<StringObject*>(obj);
+  return str_obj->str();
+}
+
+}  // namespace
+
+int64_t DB::Append(Status& status, string_view key, const string& value) {
+  if (!ReserveMemory(status)) {
+    return 0;
+  }
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
+  return AppendNoLock(status, shard, key, hash, value);
 }
 
-int64_t DB::DecrBy(Status& status, const string& key, int64_t decrement) {
+int64_t DB::Append(Status& status, string_view key, string&& value) {
+  if (!ReserveMemory(status)) {
+    return 0;
+  }
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
+  return AppendNoLock(status, shard, key, hash, move(value));
+}
+
+template <typename Value>
+int64_t DB::AppendNoLock(Status& status, Shard& shard, string_view key,
+                         size_t hash, Value&& value) {
   status = Status::OK();
-  lock_guard<mutex> lock(mutex_);
+  auto obj = shard.GetObject(key, hash);
+  if (!obj) {
+    int64_t size = value.size();
+    auto str_obj = ObjectPtr(
+        StringObject::New(shard.allocator(), key, forward<Value>(value)));
+    shard.PutObject(move(str_obj), hash);
+    return size;
+  }
+  shard.Touch(obj);
+
+  if (!obj->IsString()) {
+    status = Status::WrongType();
+    return {};
+  }
 
-  auto obj = GetObject(key);
+  auto str_obj = static_cast<StringObject*>(obj);
+  if (str_obj->IsRaw()) {
+    MemoryGuard guard(shard, str_obj);
+    shard.MarkModified(hash);
+    return str_obj->Append(value);
+  }
+
+  // kInt、kEmbStr 追加后都转成 kRaw，重新分配对象。
+  auto str = str_obj->str();
+  str.append(value);
+  auto size = str.size();
+  auto new_obj =
+      ObjectPtr(StringObject::NewRaw(shard.allocator(), key, move(str)));
+  if (obj->HasExpire()) {
+    new_obj->SetExpire(obj->expire(), obj->IsBootTime());
+  }
+  shard.ReplaceObject(move(new_obj), hash);
+  return size;
+}
+
+int64_t DB::DecrBy(Status& status, string_view key, int64_t decrement) {
+  if (!ReserveMemory(status)) {
+    return 0;
+  }
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
+  return DecrByNoLock(status, shard, key, hash, decrement);
+}
+
+int64_t DB::DecrByNoLock(Status& status, Shard& shard, string_view key,
+                         size_t hash, int64_t decrement) {
+  status = Status::OK();
+  auto obj = shard.GetObject(key, hash);
   if (!obj) {
-    auto str_obj = make_shared<StringObject>(key, expire_helper(), -decrement);
-    PutObject(key, str_obj);
+    auto str_obj =
+        ObjectPtr(StringObject::New(shard.allocator(), key, -decrement));
+    shard.PutObject(move(str_obj), hash);
     return -decrement;
   }
-  obj->Touch();
+  shard.Touch(obj);
 
   if (!obj->IsString()) {
     status = Status::WrongType();
     return {};
   }
 
-  auto str_obj = dynamic_pointer_cast<StringObject>(obj);
-  if (str_obj->IsRaw()) {
+  auto str_obj = static_cast<StringObject*>(obj);
+  if (!str_obj->IsInt()) {
     status = Status::InvalidInt64();
     return 0;
   }
   auto old_i64 = str_obj->i64();
-  if (old_i64 < INT64_MIN + decrement) {
+  if ((decrement > 0 && old_i64 < INT64_MIN + decrement) ||
+      (decrement < 0 && old_i64 > INT64_MAX + decrement)) {
     status = Status::InvalidInt64();
     return 0;
   }
   auto new_i64 = old_i64 - decrement;
+  if (!str_obj->CanSetInt64(new_i64)) {
+    str_obj = Unshare(shard, str_obj, hash);
+  }
   str_obj->set_i64(new_i64);
+  shard.MarkModified(hash);
   return new_i64;
 }
 
-int64_t DB::IncrBy(Status& status, const string& key, int64_t increment) {
-  status = Status::OK();
-  lock_guard<mutex> lock(mutex_);
+int64_t DB::IncrBy(Status& status, string_view key, int64_t increment) {
+  if (!ReserveMemory(status)) {
+    return 0;
+  }
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
+  return IncrByNoLock(status, shard, key, hash, increment);
+}
 
-  auto obj = GetObject(key);
+int64_t DB::IncrByNoLock(Status& status, Shard& shard, string_view key,
+                         size_t hash, int64_t increment) {
+  status = Status::OK();
+  auto obj = shard.GetObject(key, hash);
   if (!obj) {
-    auto str_obj = make_shared<StringObject>(key, expire_helper(), increment);
-    PutObject(key, str_obj);
+    auto str_obj =
+        ObjectPtr(StringObject::New(shard.allocator(), key, increment));
+    shard.PutObject(move(str_obj), hash);
     return increment;
   }
-  obj->Touch();
+  shard.Touch(obj);
 
   if (!obj->IsString()) {
     status = Status::WrongType();
     return {};
   }
 
-  auto str_obj = dynamic_pointer_cast<StringObject>(obj);
-  if (str_obj->IsRaw()) {
+  auto str_obj = static_cast<StringObject*>(obj);
+  if (!str_obj->IsInt()) {
     status = Status::InvalidInt64();
     return 0;
   }
   auto old_i64 = str_obj->i64();
-  if (old_i64 > INT64_MAX - increment) {
+  if ((increment > 0 && old_i64 > INT64_MAX - increment) ||
+      (increment < 0 && old_i64 < INT64_MIN - increment)) {
     status = Status::InvalidInt64();
     return 0;
   }
-  auto new_i64 = INT64_MAX - increment;
+  auto new_i64 = old_i64 + increment;
+  if (!str_obj->CanSetInt64(new_i64)) {
+    str_obj = Unshare(shard, str_obj, hash);
+  }
   str_obj->set_i64(new_i64);
+  shard.MarkModified(hash);
   return new_i64;
 }
 
-optional<string> DB::Get(Status& status, const string& key) const {
+optional<string> DB::Get(Status& status, string_view key) const {
   status = Status::OK();
-  lock_guard<mutex> lock(mutex_);
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  shared_lock<shared_mutex> lock(shard.mutex());
+  return StringValue(status, shard, shard.GetObject(key, hash, lock));
+}
 
-  auto obj = GetObject(key);
+optional<string> DB::GetNoLock(Status& status, Shard& shard, string_view key,
+                               size_t hash) const {
+  status = Status::OK();
+  return StringValue(status, shard, shard.GetObject(key, hash));
+}
+
+ValueRef DB::GetRef(Status& status, string_view key) const {
+  status = Status::OK();
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  shared_lock<shared_mutex> lock(shard.mutex());
+
+  auto obj = shard.GetObject(key, hash, lock);
   if (!obj) {
     return {};
   }
-  obj->Touch();
+  shard.Touch(obj);
 
   if (!obj->IsString()) {
     status = Status::WrongType();
     return {};
   }
 
-  auto str_obj = dynamic_pointer_cast<StringObject>(obj);
-  return str_obj->str();
+  auto str_obj = static_cast<StringObject*>(obj);
+  return str_obj->ref();
+}
+
+// 和 Redis 一样，不是字符串的键返回空值，不报错。遇到的已过期的键在释放
+// 共享锁后删除。
+vector<optional<string>> DB::MGet(const vector<string>& keys) const {
+  vector<size_t> hashes;
+  vector<size_t> indexes;
+  HashKeys(keys, hashes, indexes);
+
+  vector<optional<string>> values(keys.size());
+  vector<size_t> expired;
+  {
+    auto locks = LockShardsShared(indexes);
+    // 同一批键使用相同的访问时间，只读一次时钟。
+    auto now = shards_.front()->AccessTime();
+    ForEachKey(hashes, indexes, [&](Shard& shard, size_t i) {
+      bool is_expired = false;
+      auto obj = shard.PeekObject(keys[i], hashes[i], is_expired);
+      if (is_expired) {
+        expired.push_back(i);
+      }
+      if (!obj) {
+        return;
+      }
+      shard.Touch(obj, now);
+      if (obj->IsString()) {
+        values[i] = static_cast<StringObject*>(obj)->str();
+      }
+    });
+  }
+  EraseExpired(keys, hashes, expired);
+  return values;
 }
 
-optional<string> DB::Set(Status& status, const string& key, const string& value,
+// 同一个键出现多次时以最后一次为准。
+void DB::MSet(Status& status, const vector<pair<string, string>>& kvs) {
+  status = Status::OK();
+  if (!ReserveMemory(status)) {
+    return;
+  }
+  vector<size_t> hashes;
+  vector<size_t> indexes;
+  HashKeys(kvs, hashes, indexes);
+  auto locks = LockShards(indexes);
+
+  ForEachKey(hashes, indexes, [&](Shard& shard, size_t i) {
+    PutString(shard, kvs[i].first, hashes[i], kvs[i].second);
+  });
+}
+
+// 任何一个键已存在时都不写入，返回 0。
+int64_t DB::MSetNX(Status& status, const vector<pair<string, string>>& kvs) {
+  status = Status::OK();
+  if (!ReserveMemory(status)) {
+    return 0;
+  }
+  vector<size_t> hashes;
+  vector<size_t> indexes;
+  HashKeys(kvs, hashes, indexes);
+  auto locks = LockShards(indexes);
+
+  bool exists = false;
+  ForEachKey(hashes, indexes, [&](Shard& shard, size_t i) {
+    exists = exists || shard.GetObject(kvs[i].first, hashes[i]);
+  });
+  if (exists) {
+    return 0;
+  }
+  for (size_t i = 0; i < kvs.size(); i++) {
+    PutString(*shards_[indexes[i]], kvs[i].first, hashes[i], kvs[i].second);
+  }
+  return 1;
+}
+
+optional<string> DB::Set(Status& status, string_view key, const string& value,
+                         uint64_t flags, const Expiration& expiration) {
+  if (!ReserveMemory(status)) {
+    return {};
+  }
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
+  return SetNoLock(status, shard, key, hash, value, flags, expiration);
+}
+
+optional<string> DB::Set(Status& status, string_view key, string&& value,
                          uint64_t flags, const Expiration& expiration) {
+  if (!ReserveMemory(status)) {
+    return {};
+  }
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
+  return SetNoLock(status, shard, key, hash, move(value), flags, expiration);
+}
+
+template <typename Value>
+optional<string> DB::SetNoLock(Status& status, Shard& shard, string_view key,
+                               size_t hash, Value&& value, uint64_t flags,
+                               const Expiration& expiration) {
   status = Status::OK();
 
   flags &= NX | XX | KEEPTTL | GET;
-  if (flags & (NX & XX)) {
+  if ((flags & NX) && (flags & XX)) {
     status = Status::SyntaxError();
     return {};
   }
@@ -127,20 +370,25 @@ optional<string> DB::Set(Status& status, const string& key, const string& value,
     return {};
   }
 
-  lock_guard<mutex> lock(mutex_);
-
-  auto old_obj = GetObject(key);
+  auto old_obj = shard.GetObject(key, hash);
+  if (sketch_) {
+    sketch_->Increment(hash);
+  }
   if (!old_obj) {
     if (flags & XX) {
       return {};
     }
 
-    auto new_obj = make_shared<StringObject>(key, expire_helper(), value);
-    PutObject(key, new_obj);
+    auto new_obj = ObjectPtr(
+        StringObject::New(shard.allocator(), key, forward<Value>(value)));
+    auto obj = shard.PutObject(move(new_obj), hash);
+    if (sketch_) {
+      admission_window_.Push(key, hash, obj->MemoryUsage());
+    }
     if (expiration.px != INT64_MAX) {
-      new_obj->Px(expiration.px);
+      shard.Px(obj, hash, expiration.px);
     } else if (expiration.pxat != INT64_MAX) {
-      new_obj->Pxat(expiration.pxat);
+      shard.Pxat(obj, hash, expiration.pxat);
     }
     return (flags & GET) ? optional<string>{} : "OK";
   }
@@ -150,44 +398,104 @@ optional<string> DB::Set(Status& status, const string& key, const string& value,
       return {};
     }
     if (old_obj->IsString()) {
-      return dynamic_pointer_cast<StringObject>(old_obj)->str();
+      return static_cast<StringObject*>(old_obj)->str();
     }
     status = Status::WrongType();
     return {};
   }
 
-  if (old_obj->IsString()) {
-    old_obj->Touch();
+  if (!old_obj->IsString() && (flags & GET)) {
+    status = Status::WrongType();
+    return {};
+  }
 
-    auto str_obj = dynamic_pointer_cast<StringObject>(old_obj);
-    auto old_str = str_obj->str();
-    str_obj->Update(value);
+  optional<string> result = "OK";
+  if (flags & GET) {
+    result = static_cast<StringObject*>(old_obj)->str();
+  }
 
-    if (expiration.px != INT64_MAX) {
-      str_obj->Px(expiration.px);
-    } else if (expiration.pxat != INT64_MAX) {
-      str_obj->Pxat(expiration.pxat);
-    } else if (!(flags & KEEPTTL) && str_obj->HasExpire()) {
-      str_obj->Persist();
-    }
+  auto new_obj = ObjectPtr(
+      StringObject::New(shard.allocator(), key, forward<Value>(value)));
+  if ((flags & KEEPTTL) && old_obj->HasExpire()) {
+    new_obj->SetExpire(old_obj->expire(), old_obj->IsBootTime());
+  }
+  auto obj = shard.ReplaceObject(move(new_obj), hash);
+  if (expiration.px != INT64_MAX) {
+    shard.Px(obj, hash, expiration.px);
+  } else if (expiration.pxat != INT64_MAX) {
+    shard.Pxat(obj, hash, expiration.pxat);
+  }
+  return result;
+}
 
-    return (flags & GET) ? move(old_str) : "OK";
+// kRaw 编码的值原地交给 fn，fn 返回 true 时更新版本号并按新的大小记账。
+// 其他编码先复制出来，返回 true 时写回并重新选择编码。
+int64_t DB::Update(Status& status, string_view key, const UpdateFn& fn,
+                   const Expiration& expiration) {
+  status = Status::OK();
+  if (!ReserveMemory(status)) {
+    return 0;
   }
+  auto hash = HashKey(key);
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
 
-  if (flags & GET) {
+  auto obj = shard.GetObject(key, hash);
+  if (obj && !obj->IsString()) {
     status = Status::WrongType();
-    return {};
+    return 0;
+  }
+  auto str_obj = static_cast<StringObject*>(obj);
+
+  if (str_obj && str_obj->IsRaw()) {
+    shard.Touch(str_obj);
+    MemoryGuard guard(shard, str_obj);
+    bool modified = false;
+    try {
+      modified = fn(str_obj->MutableRaw(), true);
+    } catch (...) {
+      // fn 可能改了一半后抛出异常，按已修改处理。
+      shard.MarkModified(hash);
+      throw;
+    }
+    if (!modified) {
+      guard.Dismiss();
+      return 0;
+    }
+    shard.MarkModified(hash);
+  } else {
+    auto value = str_obj ? str_obj->str() : string();
+    if (!fn(value, str_obj != nullptr)) {
+      return 0;
+    }
+    auto new_obj =
+        ObjectPtr(StringObject::New(shard.allocator(), key, move(value)));
+    if (str_obj) {
+      if (str_obj->HasExpire()) {
+        new_obj->SetExpire(str_obj->expire(), str_obj->IsBootTime());
+      }
+      str_obj = static_cast<StringObject*>(
+          shard.ReplaceObject(move(new_obj), hash));
+    } else {
+      str_obj =
+          static_cast<StringObject*>(shard.PutObject(move(new_obj), hash));
+    }
   }
 
-  DelObject(key);
-  auto str_obj = make_shared<StringObject>(key, expire_helper(), value);
-  PutObject(key, str_obj);
   if (expiration.px != INT64_MAX) {
-    str_obj->Px(expiration.px);
+    shard.Px(str_obj, hash, expiration.px);
   } else if (expiration.pxat != INT64_MAX) {
-    str_obj->Pxat(expiration.pxat);
+    shard.Pxat(str_obj, hash, expiration.pxat);
   }
-  return "OK";
+  return 1;
 }
 
+// Exec 在 transaction.cpp 中以 const std::string& 调用。
+template int64_t DB::AppendNoLock<const string&>(Status&, Shard&, string_view,
+                                                 size_t, const string&);
+template optional<string> DB::SetNoLock<const string&>(Status&, Shard&,
+                                                       string_view, size_t,
+                                                       const string&, uint64_t,
+                                                       const Expiration&);
+
 }  // namespace libcache::db
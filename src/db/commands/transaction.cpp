@@ -0,0 +1,105 @@
+#include "db/db.hpp"
+
+using std::move;
+using std::optional;
+using std::string;
+using std::vector;
+
+namespace libcache::db {
+
+vector<uint64_t> DB::Versions(const vector<string>& keys) const {
+  vector<size_t> hashes;
+  vector<size_t> indexes;
+  HashKeys(keys, hashes, indexes);
+  auto locks = LockShardsShared(indexes);
+
+  vector<uint64_t> versions(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    versions[i] = shards_[indexes[i]]->Version(hashes[i]);
+  }
+  return versions;
+}
+
+// 监视的键和命令涉及的分片一起加锁，检查版本号和执行命令之间没有其他写入。
+optional<vector<BatchResult>> DB::Exec(const Batch& batch) {
+  // 超过内存上限时先淘汰，仍然不能写入时只拒绝可能增加内存的命令。
+  auto memory_status = Status::OK();
+  bool writable = ReserveMemory(memory_status);
+
+  vector<size_t> hashes;
+  vector<size_t> indexes;
+  HashKeys(batch.commands_, hashes, indexes);
+  vector<size_t> watch_hashes;
+  vector<size_t> lock_indexes;
+  HashKeys(batch.watches_, watch_hashes, lock_indexes);
+  lock_indexes.insert(lock_indexes.end(), indexes.begin(), indexes.end());
+  auto locks = LockShards(move(lock_indexes));
+
+  for (size_t i = 0; i < batch.watches_.size(); i++) {
+    auto hash = watch_hashes[i];
+    if (GetShard(hash).Version(hash) != batch.watches_[i].version) {
+      return {};
+    }
+  }
+
+  vector<BatchResult> results(batch.commands_.size());
+  ForEachKey(hashes, indexes, [&](Shard& shard, size_t i) {
+    if (!writable && MayGrow(batch.commands_[i])) {
+      results[i].status = memory_status;
+      return;
+    }
+    ExecCommand(batch.commands_[i], shard, hashes[i], results[i]);
+  });
+  return results;
+}
+
+bool DB::MayGrow(const Batch::Command& command) {
+  switch (command.op) {
+    case Batch::Op::kAppend:
+    case Batch::Op::kDecrBy:
+    case Batch::Op::kIncrBy:
+    case Batch::Op::kSet:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void DB::ExecCommand(const Batch::Command& command, Shard& shard, size_t hash,
+                     BatchResult& result) {
+  auto& status = result.status;
+  const auto& key = command.key;
+  switch (command.op) {
+    case Batch::Op::kAppend:
+      result.integer = AppendNoLock(status, shard, key, hash, command.value);
+      break;
+    case Batch::Op::kDecrBy:
+      result.integer = DecrByNoLock(status, shard, key, hash, command.integer);
+      break;
+    case Batch::Op::kDel:
+      result.integer = shard.DelObject(key, hash, false);
+      break;
+    case Batch::Op::kGet:
+      result.str = GetNoLock(status, shard, key, hash);
+      break;
+    case Batch::Op::kIncrBy:
+      result.integer = IncrByNoLock(status, shard, key, hash, command.integer);
+      break;
+    case Batch::Op::kPExpire:
+      result.integer = PExpireNoLock(status, shard, key, hash, command.integer,
+                                     command.flags);
+      break;
+    case Batch::Op::kPersist:
+      result.integer = PersistNoLock(shard, key, hash);
+      break;
+    case Batch::Op::kPttl:
+      result.integer = PttlNoLock(shard, key, hash);
+      break;
+    case Batch::Op::kSet:
+      result.str = SetNoLock(status, shard, key, hash, command.value,
+                             command.flags, command.expiration);
+      break;
+  }
+}
+
+}  // namespace libcache::db
@@ -1,57 +1,139 @@
 #include "db.hpp"
 
+#include <algorithm>
+#include <chrono>
+
 #include "snapshot/snapshot.hpp"
 #include "string_object.hpp"
 
-using libcache::expire::BootTime;
-using libcache::expire::TimePoint;
-using libcache::expire::UnixTime;
 using libcache::snapshot::SnapshotReader;
 using libcache::snapshot::SnapshotWriter;
 using std::lock_guard;
+using std::make_unique;
+using std::max;
+using std::min;
+using std::move;
 using std::mutex;
-using std::shared_ptr;
+using std::shared_lock;
+using std::shared_mutex;
+using std::sort;
 using std::string;
+using std::unique;
+using std::unique_lock;
 using std::unique_ptr;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
 
 namespace libcache::db {
 
-Object::ExpireHelper DB::expire_helper() {
-  Object::ExpireHelper helper;
-  helper.px = [this](const string& key, int64_t ms) -> BootTime {
-    int64_t at = ms + BootTime::Now();
-    return boot_tw_.Add(at, [this, key = key]() { OnExpired(key); });
-  };
-  helper.pxat = [this](const string& key, int64_t ms) -> UnixTime {
-    return unix_tw_.Add(ms, [this, key = key]() { OnExpired(key); });
-  };
-  helper.persist = [this](const TimePoint* tp) {
-    if (tp->type() == TimePoint::Type::kUnixTime) {
-      auto ut = *dynamic_cast<const UnixTime*>(tp);
-      unix_tw_.Remove(ut);
-    } else {
-      auto bt = *dynamic_cast<const BootTime*>(tp);
-      boot_tw_.Remove(bt);
+DB::DB(const DBOptions& options, size_t timer_interval, LazyFree& lazy_free,
+       MemoryCounter& cache_memory)
+    : memory_(options.maxmemory, &cache_memory),
+      sketch_(options.admission_filter
+                  ? make_unique<FrequencySketch>(options.maxmemory /
+                                                 kAdmissionBytesPerKey)
+                  : nullptr),
+      shards_(options.shard_count),
+      min_expire_budget_us_(options.expire_cycle_budget_us),
+      max_expire_budget_us_(max<int64_t>(
+          timer_interval * 1000 * options.expire_cycle_max_percent / 100,
+          min_expire_budget_us_)),
+      expire_budget_us_(min_expire_budget_us_),
+      eviction_policy_(options.eviction_policy),
+      eviction_samples_(options.eviction_samples),
+      admission_window_(
+          max(options.maxmemory * options.admission_window_percent / 100,
+              options.shard_count * MemoryCounter::kBatchBytes)) {
+  size_t capacity = options.hash_table_capacity / options.shard_count;
+  for (auto& shard : shards_) {
+    shard = make_unique<Shard>(options, capacity, timer_interval, lazy_free,
+                               memory_, sketch_.get());
+  }
+  expire_stats_.cycle_budget_us = expire_budget_us_;
+}
+
+void DB::ActiveEvictCycle() {
+  if (eviction_policy_ == EvictionPolicy::kNoEviction) {
+    return;
+  }
+  auto deadline = steady_clock::now() + microseconds(min_expire_budget_us_);
+  while (memory_.OverLimit() && steady_clock::now() < deadline) {
+    if (Evict(kEvictionsPerWrite) == 0) {
+      break;
     }
-  };
-  return helper;
+  }
 }
 
-void DB::CleanUpExpired() {
-  lock_guard<mutex> lock(mutex_);
-  unix_tw_.Tick();
-  boot_tw_.Tick();
+// 和 Redis 的主动过期类似，按批删除已到期的键，批与批之间释放分片的锁并检查
+// 预算。预算用完时记下停在哪个分片，已到期的键比例较高时下个周期加倍预算，
+// 处理完后逐步减回最小预算。
+void DB::ActiveExpireCycle() {
+  auto start = steady_clock::now();
+  auto deadline = start + microseconds(expire_budget_us_);
+  struct ExpireStats before;
+  for (auto& shard : shards_) {
+    shard->Tick();
+    shard->AddExpireStats(before);
+  }
+
+  size_t expired = 0;
+  bool finished = true;
+  for (size_t i = 0; i < shards_.size() && finished; i++) {
+    auto& shard = *shards_[expire_cursor_];
+    while (true) {
+      size_t count = shard.CleanUpExpired(kExpireBatch);
+      expired += count;
+      if (count < kExpireBatch) {
+        break;
+      }
+      if (steady_clock::now() >= deadline) {
+        finished = false;
+        break;
+      }
+    }
+    if (finished) {
+      expire_cursor_ = (expire_cursor_ + 1) % shards_.size();
+    }
+  }
+  auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+
+  if (!finished &&
+      before.backlog * 100 > before.volatile_keys * kStalePercent) {
+    expire_budget_us_ = min(expire_budget_us_ * 2, max_expire_budget_us_);
+  } else {
+    expire_budget_us_ = max(expire_budget_us_ / 2, min_expire_budget_us_);
+  }
+
+  lock_guard<mutex> lock(expire_stats_mutex_);
+  expire_stats_.cycles++;
+  expire_stats_.expired_keys += expired;
+  expire_stats_.time_us += elapsed.count();
+  expire_stats_.last_cycle_expired_keys = expired;
+  expire_stats_.last_cycle_time_us = elapsed.count();
+  expire_stats_.cycle_budget_us = expire_budget_us_;
 }
 
 void DB::DumpSnapshot(Status& status, const string& path) const {
   status = Status::OK();
-  lock_guard<mutex> lock(mutex_);
+  auto locks = LockAllShards();
 
   unique_ptr<SnapshotWriter> writer;
   status = SnapshotWriter::Open(path, writer);
-  for (const auto& [key, _] : objects_) {
-    auto obj = GetObject(key);
-    status = writer->Append(key, obj);
+  if (status.error()) {
+    return;
+  }
+  for (const auto& shard : shards_) {
+    shard->ForEachObject([&](const Object* obj) {
+      if (status.error()) {
+        return;
+      }
+      if (obj->HasExpire() && obj->pttl() <= 0) {
+        return;
+      }
+      status = writer->Append(obj);
+    });
     if (status.error()) {
       return;
     }
@@ -60,8 +142,10 @@ void DB::DumpSnapshot(Status& status, const string& path) const {
 
 void DB::LoadSnapshot(Status& status, const string& path) {
   status = Status::OK();
-  lock_guard<mutex> lock(mutex_);
-  ClearNoLock();
+  auto locks = LockAllShards();
+  for (auto& shard : shards_) {
+    shard->ClearNoLock();
+  }
 
   unique_ptr<SnapshotReader> reader;
   status = SnapshotReader::Open(path, reader);
@@ -70,66 +154,247 @@ void DB::LoadSnapshot(Status& status, const string& path) {
   }
 
   while (1) {
-    shared_ptr<Object> obj;
-    status = reader->Read(obj, expire_helper());
+    snapshot::Object record;
+    status = reader->Read(record);
     if (status.code() == kEof) {
+      status = Status::OK();
       return;
     }
     if (status.error()) {
-      ClearNoLock();
-      return;
+      break;
+    }
+
+    auto hash = HashKey(record.key());
+    auto& shard = GetShard(hash);
+    auto obj = ObjectPtr(Object::Deserialize(shard.allocator(), record));
+    if (!obj) {
+      status = Status::Corrupt();
+      break;
+    }
+    shard.PutObject(move(obj), hash);
+  }
+
+  for (auto& shard : shards_) {
+    shard->ClearNoLock();
+  }
+}
+
+MemoryStats DB::MemoryStats() const {
+  struct MemoryStats stats;
+  for (const auto& shard : shards_) {
+    shard->AddMemoryStats(stats);
+  }
+  stats.peak_memory = max(memory_.peak(), stats.used_memory);
+  stats.maxmemory = memory_.limit();
+  {
+    lock_guard<mutex> lock(eviction_mutex_);
+    stats.evicted_keys = evicted_keys_;
+    stats.rejected_keys = rejected_keys_;
+  }
+  // slab 中的块按块大小计入了 used_memory，其余分配按实际大小计入。
+  if (stats.used_memory > 0) {
+    auto allocated = stats.regions * SlabAllocator::kRegionSize +
+                     stats.used_memory - stats.used_bytes;
+    stats.fragmentation_ratio =
+        static_cast<double>(allocated) / stats.used_memory;
+  }
+  return stats;
+}
+
+ExpireStats DB::ExpireStats() const {
+  struct ExpireStats stats;
+  {
+    lock_guard<mutex> lock(expire_stats_mutex_);
+    stats = expire_stats_;
+  }
+  {
+    lock_guard<mutex> lock(eviction_mutex_);
+    stats.evicted_keys = evicted_volatile_keys_;
+  }
+  for (const auto& shard : shards_) {
+    shard->AddExpireStats(stats);
+  }
+  return stats;
+}
+
+void DB::FlushDB(FlushMode mode) {
+  auto locks = LockAllShards();
+  for (auto& shard : shards_) {
+    if (mode == FlushMode::kAsync) {
+      shard->ClearAsyncNoLock();
+    } else {
+      shard->ClearNoLock();
     }
+  }
+}
 
-    PutObject(obj->key(), obj);
+bool DB::ReserveMemory(Status& status) {
+  if (!memory_.OverLimit()) {
+    return true;
+  }
+  if (eviction_policy_ == EvictionPolicy::kNoEviction ||
+      Evict(kEvictionsPerWrite) == 0) {
+    status = Status::OutOfMemory();
+    return false;
   }
+  return true;
 }
 
-void DB::ClearNoLock() {
-  for (auto& [_, obj] : objects_) {
-    if (obj->HasExpire()) {
-      obj->Persist();
+// 每淘汰一个键立即提交分片的计数，再检查是否仍超过上限。
+size_t DB::Evict(size_t limit) {
+  lock_guard<mutex> lock(eviction_mutex_);
+  size_t deleted = 0;
+  while (deleted < limit && memory_.OverLimit() && EvictOne()) {
+    deleted++;
+  }
+  return deleted;
+}
+
+// 每轮从下一个分片采样 eviction_samples_ 个键放进淘汰池，再取出分数最高的键
+// 删除。池中的键可能已被删除或不再有过期时间，依次尝试下一个，所有分片
+// 都没有可淘汰的键时返回 false。
+bool DB::EvictOne() {
+  if (eviction_policy_ == EvictionPolicy::kVolatileTTL) {
+    return EvictNearestExpire();
+  }
+  bool volatile_only = VolatileOnly();
+  for (size_t i = 0; i < shards_.size(); i++) {
+    auto& shard = *shards_[eviction_cursor_];
+    eviction_cursor_ = (eviction_cursor_ + 1) % shards_.size();
+    {
+      shared_lock<shared_mutex> lock(shard.mutex());
+      auto now = shard.AccessTime();
+      auto sample = [&](const Object* obj) {
+        eviction_pool_.Insert(EvictionScore(shard, obj, now), obj->key(),
+                              HashKey(obj->key()));
+      };
+      shard.SampleObjects(volatile_only, eviction_rng_(), eviction_samples_,
+                          sample);
+    }
+
+    if (sketch_ && EvictAdmissionCandidate()) {
+      return true;
+    }
+    size_t hash = 0;
+    while (eviction_pool_.Pop(eviction_key_, hash)) {
+      if (EvictKey(eviction_key_, hash, volatile_only)) {
+        return true;
+      }
     }
   }
-  objects_.clear();
+  return false;
 }
 
-shared_ptr<Object> DB::GetObject(const string& key) const {
-  auto it = objects_.find(key);
-  if (it == objects_.end()) {
-    return nullptr;
+// 离开窗口的键和淘汰池中分数最高的键比较 sketch 估计的频率，不更高时淘汰
+// 它自己，否则留在键空间中，照常淘汰池中的键。
+bool DB::EvictAdmissionCandidate() {
+  size_t hash = 0;
+  if (!admission_window_.PopOverflow(admission_key_, hash)) {
+    return false;
+  }
+  size_t victim_hash = 0;
+  if (eviction_pool_.Peek(victim_hash) &&
+      sketch_->Estimate(hash) > sketch_->Estimate(victim_hash)) {
+    return false;
   }
+  if (!EvictKey(admission_key_, hash, false)) {
+    return false;
+  }
+  rejected_keys_++;
+  return true;
+}
 
-  auto obj = it->second;
-  if (!obj->HasExpire()) {
-    return obj;
+bool DB::EvictKey(const string& key, size_t hash, bool volatile_only) {
+  auto& shard = GetShard(hash);
+  lock_guard<shared_mutex> lock(shard.mutex());
+  auto obj = shard.GetObject(key, hash);
+  if (!obj || (volatile_only && !obj->HasExpire())) {
+    return false;
+  }
+  evicted_keys_++;
+  if (obj->HasExpire()) {
+    evicted_volatile_keys_++;
   }
+  shard.DelObject(key, hash);
+  shard.PublishMemory();
+  return true;
+}
 
-  int64_t pttl = obj->pttl();
-  if (pttl <= 0) {
-    return nullptr;
+// 从下一个分片的时间轮中取剩余时间最短的键，各分片轮流淘汰。时间轮推进后
+// 排在最前的是已经到期的键，按过期删除，不计入淘汰。
+bool DB::EvictNearestExpire() {
+  for (size_t i = 0; i < shards_.size(); i++) {
+    auto& shard = *shards_[eviction_cursor_];
+    eviction_cursor_ = (eviction_cursor_ + 1) % shards_.size();
+    lock_guard<shared_mutex> lock(shard.mutex());
+    auto obj = shard.NearestExpire();
+    if (!obj) {
+      continue;
+    }
+    auto key = obj->key();
+    auto hash = HashKey(key);
+    if (obj->pttl() > 0) {
+      evicted_keys_++;
+      evicted_volatile_keys_++;
+      shard.DelObject(key, hash);
+    } else {
+      shard.GetObject(key, hash);
+    }
+    shard.PublishMemory();
+    return true;
   }
+  return false;
+}
+
+vector<unique_lock<shared_mutex>> DB::LockShards(vector<size_t> indexes) const {
+  sort(indexes.begin(), indexes.end());
+  indexes.erase(unique(indexes.begin(), indexes.end()), indexes.end());
 
-  return obj;
+  vector<unique_lock<shared_mutex>> locks;
+  locks.reserve(indexes.size());
+  for (auto index : indexes) {
+    locks.emplace_back(shards_[index]->mutex());
+  }
+  return locks;
 }
 
-void DB::PutObject(const std::string& key, std::shared_ptr<Object> obj) {
-  assert(!GetObject(key));
-  objects_.erase(key);
-  assert(key == obj->key());
-  objects_[key] = obj;
+void DB::EraseExpired(const vector<string>& keys, const vector<size_t>& hashes,
+                      const vector<size_t>& expired) const {
+  if (expired.empty()) {
+    return;
+  }
+  vector<size_t> indexes;
+  indexes.reserve(expired.size());
+  for (auto i : expired) {
+    indexes.push_back(ShardIndex(hashes[i]));
+  }
+  auto locks = LockShards(indexes);
+  // 换锁期间键可能已被删除或改写，EraseIfExpired 会重新检查。
+  for (auto i : expired) {
+    GetShard(hashes[i]).EraseIfExpired(keys[i], hashes[i]);
+  }
 }
 
-void DB::DelObject(const string& key) {
-  assert(GetObject(key));
-  objects_.erase(key);
+vector<shared_lock<shared_mutex>> DB::LockShardsShared(
+    vector<size_t> indexes) const {
+  sort(indexes.begin(), indexes.end());
+  indexes.erase(unique(indexes.begin(), indexes.end()), indexes.end());
+
+  vector<shared_lock<shared_mutex>> locks;
+  locks.reserve(indexes.size());
+  for (auto index : indexes) {
+    locks.emplace_back(shards_[index]->mutex());
+  }
+  return locks;
 }
 
-void DB::OnExpired(const string& key) {
-  auto it = objects_.find(key);
-  assert(it != objects_.end());
-  auto obj = it->second;
-  assert(obj->HasExpire());
-  objects_.erase(it);
+vector<unique_lock<shared_mutex>> DB::LockAllShards() const {
+  vector<unique_lock<shared_mutex>> locks;
+  locks.reserve(shards_.size());
+  for (const auto& shard : shards_) {
+    locks.emplace_back(shard->mutex());
+  }
+  return locks;
 }
 
 }  // namespace libcache::db
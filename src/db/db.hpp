@@ -3,68 +3,241 @@
 
 #include <memory>
 #include <mutex>
+#include <random>
+#include <shared_mutex>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
+#include <vector>
 
-#include "expire/time_wheel.hpp"
+#include "eviction.hpp"
+#include "libcache/batch.hpp"
 #include "libcache/libcache.hpp"
-#include "object.hpp"
+#include "shard.hpp"
 
 namespace libcache::db {
 
 class DB {
  public:
-  explicit DB(const DBOptions& options)
-      : unix_tw_(options.time_wheel_size), boot_tw_(options.time_wheel_size) {}
+  // 内存用量同时计入整个 Cache 的 cache_memory。
+  DB(const DBOptions& options, size_t timer_interval, LazyFree& lazy_free,
+     MemoryCounter& cache_memory);
   ~DB() { FlushDB(); }
 
-  void CleanUpExpired();
+  // 定时器回调中调用，在时间预算内删除已到期的键，下次从没处理完的分片继续。
+  void ActiveExpireCycle();
+  // 定时器回调中调用。写命令每次只淘汰有限个键，内存仍超过上限时在这里按
+  // 主动过期的最小预算继续淘汰。
+  void ActiveEvictCycle();
 
   void DumpSnapshot(Status& status, const std::string& path) const;
   void LoadSnapshot(Status& status, const std::string& path);
 
-  void FlushDB() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    ClearNoLock();
-  }
-  std::optional<Encoding> ObjectEncoding(const std::string& key) const;
-  std::optional<int64_t> ObjectIdletime(const std::string& key) const;
-  int64_t Persist(const std::string& key) const;
-  int64_t PExpire(Status& status, const std::string& key, int64_t milliseconds,
+  struct MemoryStats MemoryStats() const;
+  struct ExpireStats ExpireStats() const;
+
+  void FlushDB(FlushMode mode = FlushMode::kSync);
+  int64_t Del(const std::vector<std::string>& keys);
+  int64_t Exists(const std::vector<std::string>& keys) const;
+  std::optional<Encoding> ObjectEncoding(std::string_view key) const;
+  std::optional<int64_t> ObjectFreq(Status& status, std::string_view key) const;
+  std::optional<int64_t> ObjectIdletime(std::string_view key) const;
+  int64_t Persist(std::string_view key) const;
+  int64_t PExpire(Status& status, std::string_view key, int64_t milliseconds,
                   uint64_t flags);
-  int64_t PExpireAt(Status& status, const std::string& key,
+  int64_t PExpireAt(Status& status, std::string_view key,
                     int64_t unix_time_milliseconds, uint64_t flags);
-  int64_t PExpireTime(const std::string& key) const;
-  int64_t Pttl(const std::string& key) const;
+  int64_t PExpireTime(std::string_view key) const;
+  int64_t Pttl(std::string_view key) const;
   int64_t Touch(const std::vector<std::string>& keys);
-  enum Type Type(const std::string& key) const;
+  enum Type Type(std::string_view key) const;
+  int64_t Unlink(const std::vector<std::string>& keys);
 
-  int64_t Append(Status& status, const std::string& key,
+  // 记下键的当前版本号。
+  std::vector<uint64_t> Versions(const std::vector<std::string>& keys) const;
+  // 锁住批次涉及的所有分片后检查版本号，有冲突时返回空值，否则依次执行。
+  std::optional<std::vector<BatchResult>> Exec(const Batch& batch);
+
+  int64_t Append(Status& status, std::string_view key,
                  const std::string& value);
-  int64_t DecrBy(Status& status, const std::string& key, int64_t decrement);
-  int64_t IncrBy(Status& status, const std::string& key, int64_t increment);
-  std::optional<std::string> Get(Status& status, const std::string& key) const;
-  std::optional<std::string> Set(Status& status, const std::string& key,
+  int64_t Append(Status& status, std::string_view key, std::string&& value);
+  int64_t DecrBy(Status& status, std::string_view key, int64_t decrement);
+  int64_t IncrBy(Status& status, std::string_view key, int64_t increment);
+  std::optional<std::string> Get(Status& status, std::string_view key) const;
+  ValueRef GetRef(Status& status, std::string_view key) const;
+  std::vector<std::optional<std::string>> MGet(
+      const std::vector<std::string>& keys) const;
+  void MSet(Status& status,
+            const std::vector<std::pair<std::string, std::string>>& kvs);
+  int64_t MSetNX(Status& status,
+                 const std::vector<std::pair<std::string, std::string>>& kvs);
+  std::optional<std::string> Set(Status& status, std::string_view key,
                                  const std::string& value, uint64_t flags,
                                  const Expiration& expiration);
+  std::optional<std::string> Set(Status& status, std::string_view key,
+                                 std::string&& value, uint64_t flags,
+                                 const Expiration& expiration);
+  int64_t Update(Status& status, std::string_view key, const UpdateFn& fn,
+                 const Expiration& expiration);
 
  private:
-  Object::ExpireHelper expire_helper();
-  void OnExpired(const std::string& key);
+  // 以下是单键命令的实现，调用方已经持有键所在分片的独占锁，Exec 也调用它们。
+  // Value 为 const std::string& 或 std::string&&，右值直接移入对象。
+  template <typename Value>
+  int64_t AppendNoLock(Status& status, Shard& shard, std::string_view key,
+                       size_t hash, Value&& value);
+  int64_t DecrByNoLock(Status& status, Shard& shard, std::string_view key,
+                       size_t hash, int64_t decrement);
+  std::optional<std::string> GetNoLock(Status& status, Shard& shard,
+                                       std::string_view key, size_t hash) const;
+  int64_t IncrByNoLock(Status& status, Shard& shard, std::string_view key,
+                       size_t hash, int64_t increment);
+  int64_t PersistNoLock(Shard& shard, std::string_view key, size_t hash) const;
+  int64_t PExpireNoLock(Status& status, Shard& shard, std::string_view key,
+                        size_t hash, int64_t milliseconds, uint64_t flags);
+  int64_t PttlNoLock(Shard& shard, std::string_view key, size_t hash) const;
+  template <typename Value>
+  std::optional<std::string> SetNoLock(Status& status, Shard& shard,
+                                       std::string_view key, size_t hash,
+                                       Value&& value, uint64_t flags,
+                                       const Expiration& expiration);
+  void ExecCommand(const Batch::Command& command, Shard& shard, size_t hash,
+                   BatchResult& result);
 
-  void ClearNoLock();
+  // 可能增加内存的写命令在加分片锁之前调用。超过 DBOptions::maxmemory 或
+  // Options::maxmemory 时按淘汰策略删除至多 kEvictionsPerWrite 个键，没有
+  // 淘汰策略或没有可淘汰的键时返回 false。
+  bool ReserveMemory(Status& status);
+  // 删除至多 limit 个键，降到上限以下时停止，返回删除的键数。volatile-ttl
+  // 策略顺带删除的已到期键也算在内，但只计入过期的统计。
+  size_t Evict(size_t limit);
+  bool EvictOne();
+  // volatile-ttl 策略的 EvictOne。
+  bool EvictNearestExpire();
+  // 开启准入过滤时在 EvictOne 中调用，淘汰了离开准入窗口的键时返回 true。
+  bool EvictAdmissionCandidate();
+  // 删除仍然存在的 key 并计数，volatile_only 时跳过没有过期时间的键。
+  bool EvictKey(const std::string& key, size_t hash, bool volatile_only);
+  bool VolatileOnly() const {
+    return eviction_policy_ == EvictionPolicy::kVolatileLRU ||
+           eviction_policy_ == EvictionPolicy::kVolatileLFU ||
+           eviction_policy_ == EvictionPolicy::kVolatileTTL;
+  }
+  // 淘汰池中的分数，越大越先淘汰：LRU 为空闲时间，LFU 为 255 减访问频率。
+  static uint64_t EvictionScore(const Shard& shard, const Object* obj,
+                                int64_t now) {
+    if (shard.lfu()) {
+      return UINT8_MAX - shard.Freq(obj, now);
+    }
+    return obj->idletime(now);
+  }
+  // Exec 中超过内存上限时拒绝执行的命令。
+  static bool MayGrow(const Batch::Command& command);
 
-  bool HasObjectIgnoreExpire(const std::string& key) const {
-    return objects_.find(key) != objects_.end();
+  // 分片下标取哈希值的高 32 位，低位留给分片内的哈希表。
+  size_t ShardIndex(size_t hash) const {
+    return (hash >> 32) * shards_.size() >> 32;
+  }
+  Shard& GetShard(size_t hash) const { return *shards_[ShardIndex(hash)]; }
+  static std::string_view KeyOf(const std::string& key) { return key; }
+  static std::string_view KeyOf(const std::pair<std::string, std::string>& kv) {
+    return kv.first;
+  }
+  static std::string_view KeyOf(const Batch::Command& command) {
+    return command.key;
   }
-  std::shared_ptr<Object> GetObject(const std::string& key) const;
-  void PutObject(const std::string& key, std::shared_ptr<Object> obj);
-  void DelObject(const std::string& key);
-
-  mutable std::mutex mutex_;
-  std::unordered_map<std::string, std::shared_ptr<Object>> objects_;
-  expire::TimeWheel<expire::UnixTime> unix_tw_;
-  expire::TimeWheel<expire::BootTime> boot_tw_;
+  static std::string_view KeyOf(const Batch::Watch& watch) {
+    return watch.key;
+  }
+  // 多键命令先算出每个键的哈希值和分片下标，再一次锁住涉及的分片。
+  template <typename T>
+  void HashKeys(const std::vector<T>& items, std::vector<size_t>& hashes,
+                std::vector<size_t>& indexes) const {
+    hashes.resize(items.size());
+    indexes.resize(items.size());
+    for (size_t i = 0; i < items.size(); i++) {
+      hashes[i] = HashKey(KeyOf(items[i]));
+      indexes[i] = ShardIndex(hashes[i]);
+    }
+  }
+  // 依次对第 i 个键调用 fn(shard, i)。处理第 i 个键时预取第
+  // i + 2 * kPrefetchDistance 个键的哈希表组，以及第 i + kPrefetchDistance
+  // 个键的候选对象，让多个键的缓存缺失重叠。
+  template <typename Fn>
+  void ForEachKey(const std::vector<size_t>& hashes,
+                  const std::vector<size_t>& indexes, Fn fn) const {
+    size_t n = hashes.size();
+    for (size_t i = 0; i < n && i < 2 * kPrefetchDistance; i++) {
+      shards_[indexes[i]]->PrefetchGroup(hashes[i]);
+    }
+    for (size_t i = 0; i < n && i < kPrefetchDistance; i++) {
+      shards_[indexes[i]]->PrefetchKeys(hashes[i]);
+    }
+    for (size_t i = 0; i < n; i++) {
+      if (i + 2 * kPrefetchDistance < n) {
+        size_t next = i + 2 * kPrefetchDistance;
+        shards_[indexes[next]]->PrefetchGroup(hashes[next]);
+      }
+      if (i + kPrefetchDistance < n) {
+        size_t next = i + kPrefetchDistance;
+        shards_[indexes[next]]->PrefetchKeys(hashes[next]);
+      }
+      fn(*shards_[indexes[i]], i);
+    }
+  }
+  // 按下标升序对分片加锁，避免多键命令之间死锁。
+  std::vector<std::unique_lock<std::shared_mutex>> LockShards(
+      std::vector<size_t> indexes) const;
+  std::vector<std::shared_lock<std::shared_mutex>> LockShardsShared(
+      std::vector<size_t> indexes) const;
+  std::vector<std::unique_lock<std::shared_mutex>> LockAllShards() const;
+  // 多键只读命令在共享锁下记下已过期的键的下标，释放共享锁后调用，加独占锁
+  // 删除这些键。
+  void EraseExpired(const std::vector<std::string>& keys,
+                    const std::vector<size_t>& hashes,
+                    const std::vector<size_t>& expired) const;
+
+  // 多键命令预取的提前量。
+  static constexpr size_t kPrefetchDistance = 16;
+  // 每次加锁最多删除的键数，预算在两批之间检查。
+  static constexpr size_t kExpireBatch = 128;
+  // 已到期的键超过有过期时间的键的这个比例时，加大主动过期的预算。
+  static constexpr size_t kStalePercent = 10;
+  static constexpr size_t kEvictionsPerWrite = 32;
+  // 按每个键占这么多字节估计键数，作为 sketch 的宽度。
+  static constexpr size_t kAdmissionBytesPerKey = 128;
+
+  // 先于 shards_ 构造、后于 shards_ 析构。
+  MemoryCounter memory_;
+  // 没有开启准入过滤时为空，和 memory_ 一样先于 shards_ 构造。
+  std::unique_ptr<FrequencySketch> sketch_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  // 以下只在定时器线程中访问。
+  int64_t min_expire_budget_us_;
+  int64_t max_expire_budget_us_;
+  int64_t expire_budget_us_;
+  size_t expire_cursor_ = 0;
+
+  mutable std::mutex expire_stats_mutex_;
+  struct ExpireStats expire_stats_;
+
+  EvictionPolicy eviction_policy_;
+  size_t eviction_samples_;
+  // 以下由 eviction_mutex_ 保护，同一时间只有一个线程在淘汰。
+  mutable std::mutex eviction_mutex_;
+  EvictionPool eviction_pool_;
+  std::mt19937_64 eviction_rng_;
+  size_t eviction_cursor_ = 0;
+  std::string eviction_key_;
+  size_t evicted_keys_ = 0;
+  // 其中有过期时间的键数。
+  size_t evicted_volatile_keys_ = 0;
+  std::string admission_key_;
+  size_t rejected_keys_ = 0;
+  // 自带锁，SetNoLock 在分片锁内写入。各分片攒够 kBatchBytes 才提交内存
+  // 计数，窗口小于这些计数之和时，一批写入会把窗口挤空，因此取两者中较大的。
+  AdmissionWindow admission_window_;
 };
 
 }  // namespace libcache::db
@@ -0,0 +1,92 @@
+#include "eviction.hpp"
+
+#include <utility>
+
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::string_view;
+using std::swap;
+
+namespace libcache::db {
+
+void EvictionPool::Insert(uint64_t score, string_view key, size_t hash) {
+  for (size_t i = 0; i < size_; i++) {
+    if (candidates_[i].hash == hash && candidates_[i].key == key) {
+      // 分数变化后重新排序，先移除再插入。
+      for (size_t j = i; j + 1 < size_; j++) {
+        swap(candidates_[j], candidates_[j + 1]);
+      }
+      size_--;
+      break;
+    }
+  }
+
+  size_t pos = 0;
+  while (pos < size_ && candidates_[pos].score < score) {
+    pos++;
+  }
+  if (size_ == kSize) {
+    if (pos == 0) {
+      return;
+    }
+    // 池满时丢弃分数最低的候选，腾出 pos 之前的位置。
+    for (size_t i = 0; i + 1 < pos; i++) {
+      swap(candidates_[i], candidates_[i + 1]);
+    }
+    pos--;
+  } else {
+    for (size_t i = size_; i > pos; i--) {
+      swap(candidates_[i], candidates_[i - 1]);
+    }
+    size_++;
+  }
+
+  auto& candidate = candidates_[pos];
+  candidate.score = score;
+  candidate.hash = hash;
+  candidate.key.assign(key);
+}
+
+bool EvictionPool::Pop(string& key, size_t& hash) {
+  if (size_ == 0) {
+    return false;
+  }
+  auto& candidate = candidates_[--size_];
+  key.swap(candidate.key);
+  hash = candidate.hash;
+  return true;
+}
+
+bool EvictionPool::Peek(size_t& hash) const {
+  if (size_ == 0) {
+    return false;
+  }
+  hash = candidates_[size_ - 1].hash;
+  return true;
+}
+
+void AdmissionWindow::Push(string_view key, size_t hash, size_t bytes) {
+  lock_guard<mutex> lock(mutex_);
+  entries_.push_back({string(key), hash, bytes});
+  bytes_ += bytes;
+  while (bytes_ > kMaxOverflow * limit_ && entries_.size() > 1) {
+    bytes_ -= entries_.front().bytes;
+    entries_.pop_front();
+  }
+}
+
+bool AdmissionWindow::PopOverflow(string& key, size_t& hash) {
+  lock_guard<mutex> lock(mutex_);
+  if (bytes_ <= limit_ || entries_.empty()) {
+    return false;
+  }
+  auto& entry = entries_.front();
+  key.swap(entry.key);
+  hash = entry.hash;
+  bytes_ -= entry.bytes;
+  entries_.pop_front();
+  return true;
+}
+
+}  // namespace libcache::db
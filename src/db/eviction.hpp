@@ -0,0 +1,72 @@
+#ifndef LIBCACHE_SRC_DB_EVICTION_HPP_
+#define LIBCACHE_SRC_DB_EVICTION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace libcache::db {
+
+// 和 Redis 的淘汰池相同：按分数从小到大保存 kSize 个候选键，每轮把新的样本
+// 中分数更高的键放进池子，淘汰时从分数最高的一端取。样本在多轮之间累积，
+// 每轮只采样少量键也能选出较好的淘汰对象。
+// 候选键在池中时可能已被删除或改写，取出后由调用方重新查找。
+class EvictionPool {
+ public:
+  static constexpr size_t kSize = 16;
+
+  // 池满且 score 不高于池中所有候选时丢弃，已在池中的键只更新分数。
+  void Insert(uint64_t score, std::string_view key, size_t hash);
+  // 取出分数最高的候选，池为空时返回 false。
+  bool Pop(std::string& key, size_t& hash);
+  // 分数最高的候选的哈希值，池为空时返回 false。
+  bool Peek(size_t& hash) const;
+  size_t size() const { return size_; }
+
+ private:
+  struct Candidate {
+    uint64_t score;
+    size_t hash;
+    // 候选移出池子后保留缓冲区，下次复用。
+    std::string key;
+  };
+
+  Candidate candidates_[kSize];
+  size_t size_ = 0;
+};
+
+// W-TinyLFU 的准入窗口：按写入顺序记录新键，总大小超过上限后，淘汰时先取出
+// 最早的键和淘汰池的候选比较访问频率。新键在窗口中有一段时间积累访问次数，
+// 突发的新热点不会一进来就被拒绝。
+// 窗口只记录键，不持有对象；自带锁，持有分片锁时也可以调用。
+class AdmissionWindow {
+ public:
+  explicit AdmissionWindow(size_t limit) : limit_(limit) {}
+
+  // 内存没到上限时不会有键离开窗口，超过 kMaxOverflow 倍上限后直接丢弃最早
+  // 的记录。
+  void Push(std::string_view key, size_t hash, size_t bytes);
+  // 总大小超过上限时取出最早的键，否则返回 false。
+  bool PopOverflow(std::string& key, size_t& hash);
+
+ private:
+  static constexpr size_t kMaxOverflow = 4;
+
+  struct Entry {
+    std::string key;
+    size_t hash;
+    size_t bytes;
+  };
+
+  std::mutex mutex_;
+  std::deque<Entry> entries_;
+  size_t bytes_ = 0;
+  size_t limit_;
+};
+
+}  // namespace libcache::db
+
+#endif  // LIBCACHE_SRC_DB_EVICTION_HPP_
@@ -0,0 +1,475 @@
+#ifndef LIBCACHE_SRC_DB_HASH_TABLE_HPP_
+#define LIBCACHE_SRC_DB_HASH_TABLE_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace libcache::db {
+
+inline size_t HashKey(std::string_view key) {
+  return std::hash<std::string_view>{}(key);
+}
+
+// 开放寻址哈希表（Swiss table）。每 16 个槽位为一组，组内的控制字节保存
+// 哈希值的低 7 位，查找时用 SSE2 一次比较整组控制字节。
+// 元素本身包含键，KeyOf 从元素中取出键。
+//
+// 扩容是渐进式的：超过负载因子时分配新表，之后每次写操作和每次 RehashStep
+// 只迁移有限个组，迁移期间查找会同时检查新旧两张表。
+template <typename T, typename KeyOf>
+class HashTable {
+ public:
+  static constexpr size_t kGroupWidth = 16;
+  // 每次写操作顺带迁移的组数。新表容量至少是旧表的 2 倍，
+  // 旧表迁移完成前新表不会被写满。
+  static constexpr size_t kRehashGroupsPerWrite = 1;
+
+  explicit HashTable(size_t capacity = 0, double max_load_factor = 0.875)
+      : max_load_factor_(max_load_factor) {
+    assert(max_load_factor > 0 && max_load_factor < 1);
+    if (capacity > 0) {
+      Reserve(capacity);
+    }
+  }
+  ~HashTable() {
+    Clear();
+    tables_[0].Free();
+  }
+
+  HashTable(const HashTable&) = delete;
+  HashTable& operator=(const HashTable&) = delete;
+
+  size_t size() const { return tables_[0].size + tables_[1].size; }
+  bool empty() const { return size() == 0; }
+  size_t capacity() const {
+    return tables_[0].capacity() + tables_[1].capacity();
+  }
+  // 控制字节和槽占用的字节数，迁移期间包括新旧两张表。
+  size_t MemoryUsage() const { return capacity() * (sizeof(T) + 1); }
+  bool rehashing() const { return tables_[1].group_count > 0; }
+  double max_load_factor() const { return max_load_factor_; }
+
+  T* Find(std::string_view key, size_t hash);
+  const T* Find(std::string_view key, size_t hash) const {
+    return const_cast<HashTable*>(this)->Find(key, hash);
+  }
+  // 批量查找时分两步预取，掩盖访存延迟：PrefetchGroup 预取 hash 所在的第一个
+  // 组的控制字节和槽位，等它们进入缓存后，PrefetchKeys 比较控制字节，预取
+  // 匹配的槽位中元素的键。
+  void PrefetchGroup(size_t hash) const;
+  void PrefetchKeys(size_t hash) const;
+  // 调用方保证键不存在。
+  T& Insert(T value, size_t hash);
+  bool Erase(std::string_view key, size_t hash);
+  void Clear();
+  void Reserve(size_t count);
+  // 迁移最多 groups 个组，返回是否仍在迁移中。
+  bool RehashStep(size_t groups);
+  void Swap(HashTable& other) {
+    std::swap(max_load_factor_, other.max_load_factor_);
+    std::swap(tables_, other.tables_);
+    std::swap(rehash_index_, other.rehash_index_);
+  }
+
+  // 随机采样：从 start 对应的槽开始顺序扫描，对遇到的至多 count 个元素调用
+  // fn，最多扫描 count * kSampleScanFactor 个槽，返回采样到的元素数。
+  template <typename Fn>
+  size_t Sample(size_t start, size_t count, Fn fn) const {
+    size_t total = capacity();
+    if (empty() || total == 0) {
+      return 0;
+    }
+    // 迁移期间两张表首尾相接。
+    size_t first = tables_[0].capacity();
+    size_t sampled = 0;
+    size_t pos = start % total;
+    for (size_t i = 0; i < total && i < count * kSampleScanFactor; i++) {
+      const auto& table = pos < first ? tables_[0] : tables_[1];
+      size_t slot = pos < first ? pos : pos - first;
+      if (IsFull(table.ctrl[slot])) {
+        fn(table.slots[slot]);
+        if (++sampled == count) {
+          break;
+        }
+      }
+      pos = pos + 1 == total ? 0 : pos + 1;
+    }
+    return sampled;
+  }
+
+  template <typename Fn>
+  void ForEach(Fn fn) const {
+    for (const auto& table : tables_) {
+      for (size_t i = 0; i < table.capacity(); i++) {
+        if (IsFull(table.ctrl[i])) {
+          fn(table.slots[i]);
+        }
+      }
+    }
+  }
+
+ private:
+  static constexpr int8_t kEmpty = -128;
+  static constexpr int8_t kDeleted = -2;
+  // 负载因子较低时也能采到足够的样本。
+  static constexpr size_t kSampleScanFactor = 16;
+
+  struct alignas(kGroupWidth) Group {
+    int8_t ctrl[kGroupWidth];
+  };
+
+  struct Table {
+    std::unique_ptr<Group[]> groups;
+    int8_t* ctrl = nullptr;
+    T* slots = nullptr;
+    size_t group_count = 0;
+    size_t size = 0;
+    size_t deleted = 0;
+
+    size_t capacity() const { return group_count * kGroupWidth; }
+    void Allocate(size_t count);
+    void Free();
+    T* Find(std::string_view key, size_t hash);
+    void PrefetchGroup(size_t hash) const;
+    void PrefetchKeys(size_t hash) const;
+    size_t FindInsertSlot(size_t hash) const;
+    T& Emplace(T&& value, size_t hash);
+    void Erase(size_t slot);
+  };
+
+  static bool IsFull(int8_t ctrl) { return ctrl >= 0; }
+  static size_t H1(size_t hash) { return hash >> 7; }
+  static int8_t H2(size_t hash) { return hash & 0x7f; }
+
+  static uint32_t Match(const int8_t* group, int8_t h2);
+  static uint32_t MatchEmpty(const int8_t* group) {
+    return Match(group, kEmpty);
+  }
+  static uint32_t MatchEmptyOrDeleted(const int8_t* group);
+
+  size_t GrowthLimit(const Table& table) const {
+    return table.capacity() * max_load_factor_;
+  }
+  bool NeedsRehash(const Table& table) const {
+    return table.size + table.deleted + 1 > GrowthLimit(table);
+  }
+  size_t GroupCountFor(size_t count) const;
+  void StartRehash(size_t group_count);
+  void FinishRehash();
+
+  double max_load_factor_;
+  // tables_[1] 非空表示正在从 tables_[0] 迁移到 tables_[1]，
+  // rehash_index_ 是旧表中下一个待迁移的组。
+  Table tables_[2];
+  size_t rehash_index_ = 0;
+};
+
+template <typename T, typename KeyOf>
+inline uint32_t HashTable<T, KeyOf>::Match(const int8_t* group, int8_t h2) {
+#ifdef __SSE2__
+  auto ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < kGroupWidth; i++) {
+    mask |= static_cast<uint32_t>(group[i] == h2) << i;
+  }
+  return mask;
+#endif
+}
+
+template <typename T, typename KeyOf>
+inline uint32_t HashTable<T, KeyOf>::MatchEmptyOrDeleted(const int8_t* group) {
+#ifdef __SSE2__
+  auto ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+  return _mm_movemask_epi8(ctrl);
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < kGroupWidth; i++) {
+    mask |= static_cast<uint32_t>(group[i] < 0) << i;
+  }
+  return mask;
+#endif
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::Table::Allocate(size_t count) {
+  assert(count > 0 && (count & (count - 1)) == 0);
+  // 默认初始化，控制字节只由下面的 memset 写一遍。
+  groups.reset(new Group[count]);
+  ctrl = groups[0].ctrl;
+  group_count = count;
+  memset(ctrl, kEmpty, capacity());
+  slots = std::allocator<T>().allocate(capacity());
+  size = 0;
+  deleted = 0;
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::Table::Free() {
+  assert(size == 0);
+  if (slots) {
+    std::allocator<T>().deallocate(slots, capacity());
+  }
+  groups.reset();
+  ctrl = nullptr;
+  slots = nullptr;
+  group_count = 0;
+  deleted = 0;
+}
+
+template <typename T, typename KeyOf>
+inline T* HashTable<T, KeyOf>::Table::Find(std::string_view key,
+                                           size_t hash) {
+  if (group_count == 0) {
+    return nullptr;
+  }
+
+  size_t mask = group_count - 1;
+  size_t index = H1(hash) & mask;
+  int8_t h2 = H2(hash);
+  for (size_t probe = 1;; probe++) {
+    const int8_t* group = ctrl + index * kGroupWidth;
+    for (auto match = Match(group, h2); match; match &= match - 1) {
+      size_t slot = index * kGroupWidth + __builtin_ctz(match);
+      if (KeyOf{}(slots[slot]) == key) {
+        return &slots[slot];
+      }
+    }
+    if (MatchEmpty(group)) {
+      return nullptr;
+    }
+    index = (index + probe) & mask;
+  }
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::Table::PrefetchGroup(size_t hash) const {
+  if (group_count == 0) {
+    return;
+  }
+  size_t index = H1(hash) & (group_count - 1);
+  __builtin_prefetch(ctrl + index * kGroupWidth);
+  __builtin_prefetch(slots + index * kGroupWidth);
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::Table::PrefetchKeys(size_t hash) const {
+  if (group_count == 0) {
+    return;
+  }
+  size_t index = H1(hash) & (group_count - 1);
+  const int8_t* group = ctrl + index * kGroupWidth;
+  for (auto match = Match(group, H2(hash)); match; match &= match - 1) {
+    size_t slot = index * kGroupWidth + __builtin_ctz(match);
+    __builtin_prefetch(KeyOf{}(slots[slot]).data());
+  }
+}
+
+template <typename T, typename KeyOf>
+inline size_t HashTable<T, KeyOf>::Table::FindInsertSlot(size_t hash) const {
+  size_t mask = group_count - 1;
+  size_t index = H1(hash) & mask;
+  for (size_t probe = 1;; probe++) {
+    auto match = MatchEmptyOrDeleted(ctrl + index * kGroupWidth);
+    if (match) {
+      return index * kGroupWidth + __builtin_ctz(match);
+    }
+    index = (index + probe) & mask;
+  }
+}
+
+template <typename T, typename KeyOf>
+inline T& HashTable<T, KeyOf>::Table::Emplace(T&& value, size_t hash) {
+  size_t slot = FindInsertSlot(hash);
+  if (ctrl[slot] == kDeleted) {
+    deleted--;
+  }
+  ctrl[slot] = H2(hash);
+  new (&slots[slot]) T(std::move(value));
+  size++;
+  return slots[slot];
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::Table::Erase(size_t slot) {
+  slots[slot].~T();
+  size--;
+  // 组内仍有空槽说明没有探测序列越过这一组，可以直接置空。
+  if (MatchEmpty(ctrl + slot / kGroupWidth * kGroupWidth)) {
+    ctrl[slot] = kEmpty;
+  } else {
+    ctrl[slot] = kDeleted;
+    deleted++;
+  }
+}
+
+template <typename T, typename KeyOf>
+inline T* HashTable<T, KeyOf>::Find(std::string_view key, size_t hash) {
+  if (rehashing()) {
+    T* value = tables_[1].Find(key, hash);
+    if (value) {
+      return value;
+    }
+  }
+  return tables_[0].Find(key, hash);
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::PrefetchGroup(size_t hash) const {
+  tables_[0].PrefetchGroup(hash);
+  tables_[1].PrefetchGroup(hash);
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::PrefetchKeys(size_t hash) const {
+  tables_[0].PrefetchKeys(hash);
+  tables_[1].PrefetchKeys(hash);
+}
+
+template <typename T, typename KeyOf>
+inline T& HashTable<T, KeyOf>::Insert(T value, size_t hash) {
+  assert(!Find(KeyOf{}(value), hash));
+  RehashStep(kRehashGroupsPerWrite);
+
+  if (!rehashing() && NeedsRehash(tables_[0])) {
+    // 墓碑过多时按原容量重建，否则按需扩容。
+    auto& table = tables_[0];
+    if (table.size + 1 <= GrowthLimit(table) / 2) {
+      StartRehash(table.group_count);
+    } else {
+      StartRehash(GroupCountFor(table.size + 1));
+    }
+  }
+  if (rehashing() && NeedsRehash(tables_[1])) {
+    // 正常情况下不会走到这里，兜底时一次性完成迁移再扩容。
+    FinishRehash();
+    StartRehash(GroupCountFor(tables_[0].size + 1));
+  }
+
+  auto& table = rehashing() ? tables_[1] : tables_[0];
+  return table.Emplace(std::move(value), hash);
+}
+
+template <typename T, typename KeyOf>
+inline bool HashTable<T, KeyOf>::Erase(std::string_view key, size_t hash) {
+  bool erased = false;
+  for (auto& table : tables_) {
+    T* value = table.Find(key, hash);
+    if (value) {
+      table.Erase(value - table.slots);
+      erased = true;
+      break;
+    }
+  }
+  RehashStep(kRehashGroupsPerWrite);
+  return erased;
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::Clear() {
+  for (auto& table : tables_) {
+    for (size_t i = 0; i < table.capacity(); i++) {
+      if (IsFull(table.ctrl[i])) {
+        table.slots[i].~T();
+      }
+    }
+    if (table.ctrl) {
+      memset(table.ctrl, kEmpty, table.capacity());
+    }
+    table.size = 0;
+    table.deleted = 0;
+  }
+  if (rehashing()) {
+    tables_[0].Free();
+    tables_[0] = std::move(tables_[1]);
+    tables_[1] = Table();
+  }
+  rehash_index_ = 0;
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::Reserve(size_t count) {
+  FinishRehash();
+  if (count > GrowthLimit(tables_[0])) {
+    StartRehash(GroupCountFor(count));
+    FinishRehash();
+  }
+}
+
+template <typename T, typename KeyOf>
+inline bool HashTable<T, KeyOf>::RehashStep(size_t groups) {
+  if (!rehashing()) {
+    return false;
+  }
+
+  auto& from = tables_[0];
+  auto& to = tables_[1];
+  for (; groups > 0 && rehash_index_ < from.group_count; groups--) {
+    size_t begin = rehash_index_ * kGroupWidth;
+    for (size_t slot = begin; slot < begin + kGroupWidth; slot++) {
+      if (!IsFull(from.ctrl[slot])) {
+        continue;
+      }
+      // 迁走的槽位标记为墓碑，保证旧表中其他键的探测序列不被截断。
+      size_t hash = HashKey(KeyOf{}(from.slots[slot]));
+      to.Emplace(std::move(from.slots[slot]), hash);
+      from.slots[slot].~T();
+      from.ctrl[slot] = kDeleted;
+      from.size--;
+    }
+    rehash_index_++;
+  }
+
+  if (rehash_index_ < from.group_count) {
+    return true;
+  }
+  from.Free();
+  from = std::move(to);
+  to = Table();
+  rehash_index_ = 0;
+  return false;
+}
+
+template <typename T, typename KeyOf>
+inline size_t HashTable<T, KeyOf>::GroupCountFor(size_t count) const {
+  size_t group_count =
+      tables_[0].group_count == 0 ? 1 : tables_[0].group_count * 2;
+  while (static_cast<size_t>(group_count * kGroupWidth * max_load_factor_) <
+         count) {
+    group_count *= 2;
+  }
+  return group_count;
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::StartRehash(size_t group_count) {
+  assert(!rehashing());
+  if (tables_[0].group_count == 0) {
+    tables_[0].Allocate(group_count);
+    return;
+  }
+  tables_[1].Allocate(group_count);
+  rehash_index_ = 0;
+}
+
+template <typename T, typename KeyOf>
+inline void HashTable<T, KeyOf>::FinishRehash() {
+  while (RehashStep(SIZE_MAX)) {
+  }
+}
+
+}  // namespace libcache::db
+
+#endif  // LIBCACHE_SRC_DB_HASH_TABLE_HPP_
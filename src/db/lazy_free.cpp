@@ -0,0 +1,58 @@
+#include "lazy_free.hpp"
+
+using std::lock_guard;
+using std::move;
+using std::mutex;
+using std::unique_lock;
+using std::unique_ptr;
+
+namespace libcache::db {
+
+LazyFree::~LazyFree() {
+  {
+    lock_guard<mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+size_t LazyFree::pending() const {
+  lock_guard<mutex> lock(mutex_);
+  return queue_.size() + freeing_;
+}
+
+size_t LazyFree::freed() const {
+  lock_guard<mutex> lock(mutex_);
+  return freed_;
+}
+
+void LazyFree::Push(unique_ptr<Garbage> garbage) {
+  {
+    lock_guard<mutex> lock(mutex_);
+    queue_.push_back(move(garbage));
+  }
+  cv_.notify_one();
+}
+
+void LazyFree::Loop() {
+  while (1) {
+    unique_lock<mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+
+    // 一次取走整个队列，释放时不持有锁。
+    auto batch = move(queue_);
+    queue_.clear();
+    freeing_ = batch.size();
+    lock.unlock();
+    batch.clear();
+    lock.lock();
+    freed_ += freeing_;
+    freeing_ = 0;
+  }
+}
+
+}  // namespace libcache::db
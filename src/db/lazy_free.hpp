@@ -0,0 +1,58 @@
+#ifndef LIBCACHE_SRC_DB_LAZY_FREE_HPP_
+#define LIBCACHE_SRC_DB_LAZY_FREE_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace libcache::db {
+
+// 后台释放线程，每个 Cache 一个。Free 把对象移入队列后立即返回，对象在后台
+// 线程中析构。交给后台的对象不能再依赖 Shard 的锁，例如 kRaw 的值，或者连同
+// slab 分配器一起摘下的整个分片。析构时先释放完队列中的对象。
+class LazyFree {
+ public:
+  LazyFree() : thread_([this]() { Loop(); }) {}
+  ~LazyFree();
+
+  LazyFree(const LazyFree&) = delete;
+  LazyFree& operator=(const LazyFree&) = delete;
+
+  template <typename T>
+  void Free(T value) {
+    Push(std::make_unique<Holder<T>>(std::move(value)));
+  }
+  // 还没释放完的对象数，以及后台线程累计释放的对象数。
+  size_t pending() const;
+  size_t freed() const;
+
+ private:
+  struct Garbage {
+    virtual ~Garbage() = default;
+  };
+  template <typename T>
+  struct Holder : Garbage {
+    explicit Holder(T value) : value(std::move(value)) {}
+    T value;
+  };
+
+  void Push(std::unique_ptr<Garbage> garbage);
+  void Loop();
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Garbage>> queue_;
+  // 后台线程正在释放的对象数。
+  size_t freeing_ = 0;
+  size_t freed_ = 0;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+}  // namespace libcache::db
+
+#endif  // LIBCACHE_SRC_DB_LAZY_FREE_HPP_
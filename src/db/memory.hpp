@@ -0,0 +1,56 @@
+#ifndef LIBCACHE_SRC_DB_MEMORY_HPP_
+#define LIBCACHE_SRC_DB_MEMORY_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace libcache::db {
+
+// 多个分片共用的内存计数，分片的精确计数攒够 kBatchBytes 的变化再提交一次，
+// 写命令不必每次都争抢同一个缓存行。计数因此比实际值最多相差
+// 分片数 * kBatchBytes。parent 不为空时同时计入上一级（整个 Cache）的计数。
+class MemoryCounter {
+ public:
+  static constexpr int64_t kBatchBytes = 4096;
+
+  // limit 为 0 表示不限制。
+  explicit MemoryCounter(size_t limit, MemoryCounter* parent = nullptr)
+      : limit_(limit), parent_(parent) {}
+
+  MemoryCounter(const MemoryCounter&) = delete;
+  MemoryCounter& operator=(const MemoryCounter&) = delete;
+
+  size_t limit() const { return limit_; }
+  size_t used() const {
+    auto used = used_.load(std::memory_order_relaxed);
+    return used > 0 ? used : 0;
+  }
+  size_t peak() const { return peak_.load(std::memory_order_relaxed); }
+  // 本级或上一级超过了限制。
+  bool OverLimit() const {
+    return (limit_ > 0 && used() > limit_) || (parent_ && parent_->OverLimit());
+  }
+
+  void Add(int64_t delta) {
+    auto used = used_.fetch_add(delta, std::memory_order_relaxed) + delta;
+    auto peak = peak_.load(std::memory_order_relaxed);
+    while (used > peak &&
+           !peak_.compare_exchange_weak(peak, used,
+                                        std::memory_order_relaxed)) {
+    }
+    if (parent_) {
+      parent_->Add(delta);
+    }
+  }
+
+ private:
+  size_t limit_;
+  MemoryCounter* parent_;
+  std::atomic<int64_t> used_ = 0;
+  std::atomic<int64_t> peak_ = 0;
+};
+
+}  // namespace libcache::db
+
+#endif  // LIBCACHE_SRC_DB_MEMORY_HPP_
@@ -1,48 +1,87 @@
 #include "object.hpp"
 
-using libcache::expire::BootTime;
-using libcache::expire::TimePoint;
-using libcache::expire::UnixTime;
-using std::dynamic_pointer_cast;
-using std::make_shared;
+#include <random>
+
+#include "string_object.hpp"
 
 namespace libcache::db {
 
-void Object::Px(int64_t ms) {
-  assert(!HasExpire());
-  auto tp = expire_helper_.px(key_, ms);
-  auto expire = make_shared<BootTime>(tp);
-  expire_ = dynamic_pointer_cast<TimePoint>(expire);
+uint8_t Object::freq(int64_t now, int64_t decay_ms) const {
+  uint8_t freq = freq_.load(std::memory_order_relaxed);
+  if (decay_ms <= 0) {
+    return freq;
+  }
+  int64_t periods = idletime(now) / decay_ms;
+  return periods >= freq ? 0 : freq - periods;
+}
+
+void Object::IncrFreq(int64_t now, size_t log_factor, int64_t decay_ms) {
+  thread_local std::minstd_rand rng(std::random_device{}());
+  uint8_t freq = this->freq(now, decay_ms);
+  if (freq < UINT8_MAX) {
+    double base = freq > kInitFreq ? freq - kInitFreq : 0;
+    std::uniform_real_distribution<double> dist(0, 1);
+    if (dist(rng) < 1 / (base * log_factor + 1)) {
+      freq++;
+    }
+  }
+  if (freq_.load(std::memory_order_relaxed) != freq) {
+    freq_.store(freq, std::memory_order_relaxed);
+  }
 }
 
-void Object::Pxat(int64_t ms) {
-  assert(!HasExpire());
-  auto tp = expire_helper_.pxat(key_, ms);
-  auto expire = make_shared<UnixTime>(tp);
-  expire_ = dynamic_pointer_cast<TimePoint>(expire);
+size_t Object::MemoryUsage() const {
+  switch (type()) {
+    case Type::kString:
+      return static_cast<const StringObject*>(this)->MemoryUsage();
+    default:
+      assert(false);
+      return 0;
+  }
 }
 
-void Object::Persist() {
-  assert(HasExpire());
-  expire_helper_.persist(expire_.get());
-  expire_.reset();
+std::string Object::Serialize() const {
+  switch (type()) {
+    case Type::kString:
+      return static_cast<const StringObject*>(this)->Serialize();
+    default:
+      assert(false);
+      return {};
+  }
+}
+
+Object* Object::Deserialize(SlabAllocator& allocator,
+                            const snapshot::Object& obj) {
+  if (!obj.has_string_object()) {
+    return nullptr;
+  }
+
+  Object* result =
+      StringObject::New(allocator, obj.key(), obj.string_object().value());
+  if (obj.pxat() != INT64_MAX) {
+    result->SetExpire(obj.pxat(), false);
+  }
+  return result;
 }
 
 snapshot::Object Object::SnapshotObject() const {
   snapshot::Object obj;
-  obj.set_key(key_);
+  obj.set_key(std::string(key()));
   if (!HasExpire()) {
     obj.set_pxat(INT64_MAX);
     return obj;
   }
-  obj.set_pxat(expire_->ToUnixTime());
+  obj.set_pxat(expire_unix());
   return obj;
 }
 
-void Object::Parse(const snapshot::Object& obj) {
-  key_ = obj.key();
-  if (obj.pxat() != INT64_MAX) {
-    Pxat(obj.pxat());
+void ObjectDeleter::operator()(Object* obj) const {
+  switch (obj->type()) {
+    case Type::kString:
+      StringObject::Delete(static_cast<StringObject*>(obj));
+      break;
+    default:
+      assert(false);
   }
 }
 
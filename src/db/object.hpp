@@ -1,67 +1,166 @@
 #ifndef LIBCACHE_SRC_DB_OBJECT_HPP_
 #define LIBCACHE_SRC_DB_OBJECT_HPP_
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <memory>
+#include <new>
+#include <string>
+#include <string_view>
 
 #include "expire/time_point.hpp"
+#include "expire/time_wheel.hpp"
 #include "libcache/libcache.hpp"
 #include "snapshot.pb.h"
 
 namespace libcache::db {
 
+class SlabAllocator;
+
+// 对象头 32 字节：类型、编码、标志位、访问频率、访问时间、内联的过期时间、
+// 时间轮句柄和键长度。
+// 键紧跟在对象头之后，值的存储由子类决定，对象和键只占一次分配。
+// 过期时间按 flags 中记录的时钟解释，时间轮的注册和注销由 Shard 负责。
 class Object {
  public:
-  struct ExpireHelper {
-    std::function<expire::BootTime(const std::string&, int64_t)> px;
-    std::function<expire::UnixTime(const std::string&, int64_t)> pxat;
-    std::function<void(const expire::TimePoint*)> persist;
-  };
-
-  explicit Object(std::string key, ExpireHelper expire_helper)
-      : key_(std::move(key)), expire_helper_(std::move(expire_helper)) {}
-  virtual ~Object() {
-    if (HasExpire()) {
-      Persist();
-    }
+  Object(const Object&) = delete;
+  Object& operator=(const Object&) = delete;
+
+  std::string_view key() const {
+    return {reinterpret_cast<const char*>(this + 1), key_size_};
   }
-  const std::string& key() const { return key_; }
 
-  virtual Type type() const = 0;
+  Type type() const { return static_cast<enum Type>(type_); }
   bool IsString() const { return type() == Type::kString; }
 
-  virtual Encoding encoding() const = 0;
+  Encoding encoding() const { return static_cast<Encoding>(encoding_); }
 
-  int64_t idletime() const { return expire::UnixTime::Now() - access_; }
-  void Touch() { access_ = expire::UnixTime::Now(); }
+  // now 取自 Shard::AccessTime()。
+  int64_t idletime(int64_t now) const {
+    uint32_t access = access_.load(std::memory_order_relaxed);
+    return static_cast<uint32_t>(now - access);
+  }
+  // 读命令在共享锁下调用，访问时间没有变化时不写，避免读者之间争抢缓存行。
+  void Touch(int64_t now) {
+    if (access_.load(std::memory_order_relaxed) != static_cast<uint32_t>(now)) {
+      access_.store(now, std::memory_order_relaxed);
+    }
+  }
 
+  // LFU 策略下记录的访问频率：8 位的对数计数（Morris 计数），频率越高加 1 的
+  // 概率越小，255 大约对应百万次访问。距上次访问每经过 decay_ms 毫秒减 1，
+  // 衰减在读取和下次访问时按 access_ 计算，不需要后台扫描。
+  // 新对象从 kInitFreq 开始，避免刚写入的键马上被淘汰。
+  static constexpr uint8_t kInitFreq = 5;
+  uint8_t freq(int64_t now, int64_t decay_ms) const;
+  // 在 Touch 之前调用，先衰减再按 1 / ((freq - kInitFreq) * log_factor + 1)
+  // 的概率加 1。共享锁下并发调用时可能丢失一次更新，对近似计数没有影响。
+  void IncrFreq(int64_t now, size_t log_factor, int64_t decay_ms);
+  // 覆盖写入时新对象继承旧对象的访问时间和频率。
+  void InheritAccess(const Object& other) {
+    access_.store(other.access_.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    freq_.store(other.freq_.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+  }
+
+  bool HasExpire() const { return flags_ & kHasExpire; }
+  bool IsBootTime() const { return flags_ & kBootTime; }
+  // 过期时间，按 IsBootTime() 对应的时钟计。
+  int64_t expire() const {
+    assert(HasExpire());
+    return expire_;
+  }
   int64_t pttl() const {
     assert(HasExpire());
-    return expire_->pttl();
+    return expire_ - (IsBootTime() ? expire::BootTime::Now()
+                                   : expire::UnixTime::Now());
   }
   int64_t expire_unix() const {
     assert(HasExpire());
-    return expire_->ToUnixTime();
+    return IsBootTime() ? expire::BootTime::ToUnixTime(expire_) : expire_;
   }
+  void SetExpire(int64_t at, bool boot_time) {
+    flags_ |= kHasExpire;
+    if (boot_time) {
+      flags_ |= kBootTime;
+    } else {
+      flags_ &= ~kBootTime;
+    }
+    expire_ = at;
+  }
+  void ClearExpire() { flags_ &= ~(kHasExpire | kBootTime); }
+  // 对象在时间轮中的位置，只在有过期时间时有效。
+  expire::TimerHandle& timer_handle() { return timer_; }
 
-  bool HasExpire() const { return expire_.get(); }
-  void Px(int64_t ms);
-  void Pxat(int64_t ms);
-  void Persist();
-
-  virtual std::string Serialize() = 0;
-  void Parse(const snapshot::Object& obj);
+  // 对象占用的字节数：对象头、键、值区，以及值在对象外的缓冲区。
+  size_t MemoryUsage() const;
+  std::string Serialize() const;
+  // 从快照记录创建对象，记录类型未知时返回 nullptr。
+  static Object* Deserialize(SlabAllocator& allocator,
+                             const snapshot::Object& obj);
 
  protected:
+  Object(Type type, Encoding encoding, std::string_view key)
+      : type_(static_cast<uint8_t>(type)),
+        encoding_(static_cast<uint8_t>(encoding)),
+        key_size_(key.size()) {
+    key.copy(reinterpret_cast<char*>(this + 1), key.size());
+  }
+  ~Object() = default;
+
+  // 键之后按 8 字节对齐的位置，子类在这里存放值。
+  static size_t ValueOffset(size_t key_size) {
+    return (sizeof(Object) + key_size + 7) & ~size_t(7);
+  }
+  // 值区在对象之后，从分配的起始地址计算，编译器不按 sizeof(Object) 检查
+  // 越界。
+  char* value_area() {
+    return std::launder(reinterpret_cast<char*>(this)) + ValueOffset(key_size_);
+  }
+  const char* value_area() const {
+    return std::launder(reinterpret_cast<const char*>(this)) +
+           ValueOffset(key_size_);
+  }
+
+  void set_encoding(Encoding encoding) {
+    encoding_ = static_cast<uint8_t>(encoding);
+  }
+  uint32_t value_size() const { return value_size_; }
+  void set_value_size(uint32_t value_size) { value_size_ = value_size; }
+  // 值引用共享的只读数据，对象本身没有值区。
+  bool shared() const { return flags_ & kShared; }
+  void set_shared() { flags_ |= kShared; }
+
   snapshot::Object SnapshotObject() const;
 
  private:
-  ExpireHelper expire_helper_;
-  std::string key_;
-  int64_t access_ = expire::UnixTime::Now();
-  std::shared_ptr<expire::TimePoint> expire_;
+  static constexpr uint8_t kHasExpire = 1;
+  static constexpr uint8_t kBootTime = 1 << 1;
+  static constexpr uint8_t kShared = 1 << 2;
+
+  uint8_t type_ : 4;
+  uint8_t encoding_ : 4;
+  uint8_t flags_ = 0;
+  std::atomic<uint8_t> freq_ = kInitFreq;
+  // 访问时间取单调时钟毫秒数的低 32 位，按无符号差值计算空闲时间。
+  std::atomic<uint32_t> access_ = 0;
+  int64_t expire_ = 0;
+  expire::TimerHandle timer_;
+  uint32_t key_size_;
+  uint32_t value_size_ = 0;
+};
+
+static_assert(sizeof(Object) == 32);
+
+// Object 没有虚析构函数，按类型析构并释放整块内存。
+struct ObjectDeleter {
+  void operator()(Object* obj) const;
 };
 
+using ObjectPtr = std::unique_ptr<Object, ObjectDeleter>;
+
 }  // namespace libcache::db
 
 #endif  // LIBCACHE_SRC_DB_OBJECT_HPP_
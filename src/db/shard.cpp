@@ -0,0 +1,275 @@
+#include "shard.hpp"
+
+#include "string_object.hpp"
+
+using libcache::expire::BootTime;
+using std::lock_guard;
+using std::make_unique;
+using std::move;
+using std::shared_lock;
+using std::string_view;
+
+namespace libcache::db {
+
+void Shard::Tick() {
+  lock_guard<std::shared_mutex> lock(mutex_);
+  unix_tw_.Advance();
+  boot_tw_.Advance();
+  objects_.RehashStep(kRehashGroupsPerTick);
+  SyncTableMemory();
+}
+
+size_t Shard::CleanUpExpired(size_t limit) {
+  lock_guard<std::shared_mutex> lock(mutex_);
+  auto on_expired = [this](Object* obj) { OnExpired(obj); };
+  size_t count = unix_tw_.Tick(on_expired, limit);
+  count += boot_tw_.Tick(on_expired, limit - count);
+  return count;
+}
+
+void Shard::ClearNoLock() {
+  MarkAllModified();
+  unix_tw_.Clear();
+  boot_tw_.Clear();
+  objects_.Clear();
+  ChargeMemory(table_memory_ - used_memory_);
+  SyncTableMemory();
+  allocator_->ReleaseIfEmpty();
+}
+
+void Shard::ClearAsyncNoLock() {
+  // 成员按声明的逆序析构，对象先于分配器释放。
+  struct Detached {
+    std::unique_ptr<SlabAllocator> allocator;
+    HashTable<ObjectPtr, ObjectKey> objects;
+  };
+
+  MarkAllModified();
+  unix_tw_.Clear();
+  boot_tw_.Clear();
+  auto detached = make_unique<Detached>();
+  detached->allocator = move(allocator_);
+  detached->objects.Swap(objects_);
+  allocator_ = make_unique<SlabAllocator>(huge_pages_);
+  HashTable<ObjectPtr, ObjectKey>(0, detached->objects.max_load_factor())
+      .Swap(objects_);
+  lazy_free_.Free(move(detached));
+  ChargeMemory(table_memory_ - used_memory_);
+  SyncTableMemory();
+}
+
+Object* Shard::NearestExpire() {
+  auto unix_obj = unix_tw_.Front();
+  auto boot_obj = boot_tw_.Front();
+  if (!unix_obj || !boot_obj) {
+    return unix_obj ? unix_obj : boot_obj;
+  }
+  return unix_obj->pttl() <= boot_obj->pttl() ? unix_obj : boot_obj;
+}
+
+void Shard::AddMemoryStats(MemoryStats& stats) const {
+  shared_lock<std::shared_mutex> lock(mutex_);
+  allocator_->AddStats(stats);
+  stats.used_memory += used_memory_;
+}
+
+void Shard::ChargeMemory(int64_t delta) {
+  used_memory_ += delta;
+  pending_memory_ += delta;
+  if (pending_memory_ >= MemoryCounter::kBatchBytes ||
+      pending_memory_ <= -MemoryCounter::kBatchBytes) {
+    memory_.Add(pending_memory_);
+    pending_memory_ = 0;
+  }
+}
+
+void Shard::AddExpireStats(ExpireStats& stats) const {
+  shared_lock<std::shared_mutex> lock(mutex_);
+  stats.volatile_keys += unix_tw_.size() + boot_tw_.size();
+  stats.backlog += unix_tw_.due_size() + boot_tw_.due_size();
+  stats.lazy_expired_keys += lazy_expired_;
+}
+
+Object* Shard::GetObject(string_view key, size_t hash) {
+  bool expired = false;
+  auto obj = FindObject(key, hash, expired);
+  if (expired) {
+    EraseExpired(key, hash);
+  }
+  return obj;
+}
+
+Object* Shard::GetObject(string_view key, size_t hash,
+                         shared_lock<std::shared_mutex>& lock) {
+  bool expired = false;
+  auto obj = FindObject(key, hash, expired);
+  if (expired) {
+    lock.unlock();
+    lock_guard<std::shared_mutex> exclusive(mutex_);
+    // 换锁期间键可能已被删除或改写，重新检查。
+    FindObject(key, hash, expired);
+    if (expired) {
+      EraseExpired(key, hash);
+    }
+  }
+  return obj;
+}
+
+Object* Shard::PutObject(ObjectPtr obj, size_t hash) {
+  auto key = obj->key();
+  bool expired = false;
+  assert(!FindObject(key, hash, expired));
+  if (objects_.Find(key, hash)) {
+    return ReplaceObject(move(obj), hash);
+  }
+
+  obj->Touch(AccessTime());
+  MarkModified(hash);
+  ChargeObject(obj.get());
+  auto& slot = objects_.Insert(move(obj), hash);
+  SyncTableMemory();
+  if (slot->HasExpire()) {
+    AddExpire(slot.get());
+  }
+  return slot.get();
+}
+
+Object* Shard::ReplaceObject(ObjectPtr obj, size_t hash) {
+  auto slot = objects_.Find(obj->key(), hash);
+  assert(slot);
+  if ((*slot)->HasExpire()) {
+    RemoveExpire(slot->get());
+  }
+  RefundObject(slot->get());
+  FreeValueLater(slot->get());
+  obj->InheritAccess(**slot);
+  obj->Touch(AccessTime());
+  MarkModified(hash);
+  ChargeObject(obj.get());
+  *slot = move(obj);
+  if ((*slot)->HasExpire()) {
+    AddExpire(slot->get());
+  }
+  return slot->get();
+}
+
+bool Shard::DelObject(string_view key, size_t hash, bool lazy_free) {
+  auto obj = GetObject(key, hash);
+  if (!obj) {
+    return false;
+  }
+  if (obj->HasExpire()) {
+    RemoveExpire(obj);
+  }
+  RefundObject(obj);
+  if (lazy_free) {
+    FreeValueLater(obj);
+  }
+  objects_.Erase(key, hash);
+  SyncTableMemory();
+  MarkModified(hash);
+  return true;
+}
+
+void Shard::FreeValueLater(Object* obj) {
+  if (lazy_free_threshold_ == 0 || !obj->IsString()) {
+    return;
+  }
+  auto str_obj = static_cast<StringObject*>(obj);
+  if (str_obj->IsRaw() && str_obj->view().size() > lazy_free_threshold_) {
+    lazy_free_.Free(str_obj->TakeRaw());
+  }
+}
+
+Object* Shard::FindObject(string_view key, size_t hash, bool& expired) const {
+  auto slot = objects_.Find(key, hash);
+  if (!slot) {
+    return nullptr;
+  }
+
+  auto obj = slot->get();
+  expired = obj->HasExpire() && obj->pttl() <= 0;
+  return expired ? nullptr : obj;
+}
+
+void Shard::EraseExpired(string_view key, size_t hash) {
+  auto obj = objects_.Find(key, hash)->get();
+  RemoveExpire(obj);
+  RefundObject(obj);
+  FreeValueLater(obj);
+  objects_.Erase(key, hash);
+  SyncTableMemory();
+  MarkModified(hash);
+  lazy_expired_++;
+}
+
+void Shard::Px(Object* obj, size_t hash, int64_t ms) {
+  if (obj->HasExpire()) {
+    RemoveExpire(obj);
+  }
+  obj->SetExpire(BootTime::Now() + ms, true);
+  AddExpire(obj);
+  MarkModified(hash);
+}
+
+void Shard::Pxat(Object* obj, size_t hash, int64_t unix_time_ms) {
+  if (obj->HasExpire()) {
+    RemoveExpire(obj);
+  }
+  obj->SetExpire(unix_time_ms, false);
+  AddExpire(obj);
+  MarkModified(hash);
+}
+
+void Shard::Persist(Object* obj, size_t hash) {
+  assert(obj->HasExpire());
+  RemoveExpire(obj);
+  obj->ClearExpire();
+  MarkModified(hash);
+}
+
+void Shard::AddExpire(Object* obj) {
+  if (obj->IsBootTime()) {
+    boot_tw_.Add(obj);
+  } else {
+    unix_tw_.Add(obj);
+  }
+  ChargeMemory(kExpireEntrySize);
+}
+
+void Shard::RemoveExpire(Object* obj) {
+  if (obj->IsBootTime()) {
+    boot_tw_.Remove(obj);
+  } else {
+    unix_tw_.Remove(obj);
+  }
+  ChargeMemory(-kExpireEntrySize);
+}
+
+// 时间轮已经移除了这一项，这里只需要删除对象。
+void Shard::OnExpired(Object* obj) {
+  assert(obj->HasExpire());
+  ChargeMemory(-kExpireEntrySize);
+  RefundObject(obj);
+  FreeValueLater(obj);
+  auto key = obj->key();
+  auto hash = HashKey(key);
+  objects_.Erase(key, hash);
+  SyncTableMemory();
+  MarkModified(hash);
+}
+
+void Shard::SyncTableMemory() {
+  int64_t table_memory = objects_.MemoryUsage();
+  ChargeMemory(table_memory - table_memory_);
+  table_memory_ = table_memory;
+}
+
+// 清空后所有键都算被修改过。
+void Shard::MarkAllModified() {
+  for (auto& version : versions_) {
+    version++;
+  }
+}
+
+}  // namespace libcache::db
@@ -0,0 +1,229 @@
+#ifndef LIBCACHE_SRC_DB_SHARD_HPP_
+#define LIBCACHE_SRC_DB_SHARD_HPP_
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+#include "expire/time_wheel.hpp"
+#include "hash_table.hpp"
+#include "lazy_free.hpp"
+#include "libcache/libcache.hpp"
+#include "memory.hpp"
+#include "object.hpp"
+#include "sketch.hpp"
+#include "slab.hpp"
+
+namespace libcache::db {
+
+// Shard 持有 DB 键空间的一个分片，每个分片有独立的锁和时间轮。
+// 对象的过期回调由 Shard 统一处理，对象本身只保存过期时间。
+class Shard {
+ public:
+  // tick_ms 是时间轮的刻度，和定时器的间隔相同。内存用量计入 memory。
+  // sketch 不为空时在其中记录每次访问，由 DB 的准入过滤使用。
+  Shard(const DBOptions& options, size_t capacity, int64_t tick_ms,
+        LazyFree& lazy_free, MemoryCounter& memory, FrequencySketch* sketch)
+      : coarse_clock_(options.access_clock == ClockMode::kCoarse),
+        lfu_(options.eviction_policy == EvictionPolicy::kAllKeysLFU ||
+             options.eviction_policy == EvictionPolicy::kVolatileLFU),
+        lfu_log_factor_(options.lfu_log_factor),
+        lfu_decay_time_ms_(options.lfu_decay_time_ms),
+        huge_pages_(options.huge_pages),
+        lazy_free_threshold_(options.lazy_free_threshold),
+        lazy_free_(lazy_free),
+        memory_(memory),
+        sketch_(sketch),
+        allocator_(std::make_unique<SlabAllocator>(huge_pages_)),
+        objects_(capacity, options.hash_table_load_factor),
+        unix_tw_(options.time_wheel_size, tick_ms),
+        boot_tw_(options.time_wheel_size, tick_ms) {
+    SyncTableMemory();
+  }
+  ~Shard() {
+    ClearNoLock();
+    memory_.Add(pending_memory_ - used_memory_);
+  }
+
+  // 只读命令加共享锁，修改键空间的命令加独占锁。
+  std::shared_mutex& mutex() const { return mutex_; }
+  // 访问时间的时钟，按 DBOptions::access_clock 选择精度。
+  int64_t AccessTime() const {
+    return coarse_clock_ ? expire::BootTime::NowCoarse()
+                         : expire::BootTime::Now();
+  }
+  // 命令访问键时调用，更新访问时间，LFU 策略下同时更新访问频率，开启准入
+  // 过滤时记入 sketch。
+  void Touch(Object* obj) const { Touch(obj, AccessTime()); }
+  void Touch(Object* obj, int64_t now) const {
+    if (lfu_) {
+      obj->IncrFreq(now, lfu_log_factor_, lfu_decay_time_ms_);
+    }
+    if (sketch_) {
+      sketch_->Increment(HashKey(obj->key()));
+    }
+    obj->Touch(now);
+  }
+  bool lfu() const { return lfu_; }
+  // 衰减后的访问频率，只在 LFU 策略下有意义。
+  uint8_t Freq(const Object* obj, int64_t now) const {
+    return obj->freq(now, lfu_decay_time_ms_);
+  }
+  // 本分片对象使用的分配器，需持有分片的锁。
+  SlabAllocator& allocator() { return *allocator_; }
+
+  // 推进时间轮并迁移一部分哈希表，每个定时器周期调用一次。
+  void Tick();
+  // 删除至多 limit 个已到期的键，返回删除的键数。
+  size_t CleanUpExpired(size_t limit);
+  void ClearNoLock();
+  // 摘下所有对象和分配器交给后台线程释放，分片换成空的。
+  void ClearAsyncNoLock();
+  void AddMemoryStats(MemoryStats& stats) const;
+  // 本分片精确的内存用量，需持有分片的锁。
+  size_t used_memory() const { return used_memory_; }
+  // 增删对象和过期时间时自动记账，命令原地改变值的大小时需要自己调用。
+  void ChargeMemory(int64_t delta);
+  // 立即提交攒下的变化量，淘汰时避免按滞后的计数多删键。
+  void PublishMemory() {
+    memory_.Add(pending_memory_);
+    pending_memory_ = 0;
+  }
+  // 两个时间轮的 Front 中剩余时间较短的键，近似剩余时间最短，没有有过期时间
+  // 的键时返回 nullptr。会推进
+  // 时间轮，需持有独占锁。
+  Object* NearestExpire();
+  // 累加有过期时间的键数和已到期未删除的键数。
+  void AddExpireStats(ExpireStats& stats) const;
+
+  // 多键命令在查找前分两步预取，见 HashTable::PrefetchGroup。
+  void PrefetchGroup(size_t hash) const { objects_.PrefetchGroup(hash); }
+  void PrefetchKeys(size_t hash) const { objects_.PrefetchKeys(hash); }
+  // 只读地查找未过期的键，持有共享锁即可，不删除已过期的键。
+  Object* PeekObject(std::string_view key, size_t hash) const {
+    bool expired = false;
+    return FindObject(key, hash, expired);
+  }
+  // 键已过期时把 expired 置为 true，多键命令之后加独占锁调用 EraseIfExpired。
+  Object* PeekObject(std::string_view key, size_t hash, bool& expired) const {
+    return FindObject(key, hash, expired);
+  }
+  bool HasObject(std::string_view key, size_t hash) const {
+    return PeekObject(key, hash);
+  }
+  // 需持有独占锁，键仍然已过期时删除。
+  void EraseIfExpired(std::string_view key, size_t hash) {
+    bool expired = false;
+    FindObject(key, hash, expired);
+    if (expired) {
+      EraseExpired(key, hash);
+    }
+  }
+  // 查找未过期的键，需持有独占锁，键已过期时顺便删除。
+  Object* GetObject(std::string_view key, size_t hash);
+  // 持有共享锁时查找。键已过期时释放共享锁、加独占锁删除后返回 nullptr，
+  // 调用方不能再访问分片。
+  Object* GetObject(std::string_view key, size_t hash,
+                    std::shared_lock<std::shared_mutex>& lock);
+  Object* PutObject(ObjectPtr obj, size_t hash);
+  // 用 obj 替换同名的已有对象，过期时间以 obj 为准，访问频率沿用原对象。
+  Object* ReplaceObject(ObjectPtr obj, size_t hash);
+  // 删除未过期的键并返回 true。lazy_free 为 true 时较大的值由后台线程释放。
+  bool DelObject(std::string_view key, size_t hash, bool lazy_free = true);
+
+  void Px(Object* obj, size_t hash, int64_t ms);
+  void Pxat(Object* obj, size_t hash, int64_t unix_time_ms);
+  void Persist(Object* obj, size_t hash);
+
+  // 键的版本号，Watch 时记下，Exec 时比较。版本号按哈希值分桶，不同的键可能
+  // 共用一个版本号，只会多报冲突，不会漏报。
+  uint64_t Version(size_t hash) const {
+    return versions_[hash % kVersionSlots];
+  }
+  // 上面修改键的方法会自动更新版本号，命令原地修改值时需要自己调用。
+  void MarkModified(size_t hash) { versions_[hash % kVersionSlots]++; }
+
+  // 从随机位置 start 开始对至多 count 个对象调用 fn(Object*)，volatile_only
+  // 时只在有过期时间的键中采样，返回采样到的对象数。需持有分片的锁。
+  template <typename Fn>
+  size_t SampleObjects(bool volatile_only, size_t start, size_t count,
+                       Fn fn) const {
+    if (!volatile_only) {
+      return objects_.Sample(
+          start, count, [&fn](const ObjectPtr& obj) { fn(obj.get()); });
+    }
+    // 两个时间轮轮流先采样。
+    size_t sampled = 0;
+    if (start & 1) {
+      sampled += unix_tw_.Sample(start >> 1, count, fn);
+    }
+    sampled += boot_tw_.Sample(start >> 1, count - sampled, fn);
+    if (!(start & 1)) {
+      sampled += unix_tw_.Sample(start >> 1, count - sampled, fn);
+    }
+    return sampled;
+  }
+
+  template <typename Fn>
+  void ForEachObject(Fn fn) const {
+    objects_.ForEach([&fn](const ObjectPtr& obj) { fn(obj.get()); });
+  }
+
+ private:
+  // 每次定时器回调时额外迁移的哈希表组数。
+  static constexpr size_t kRehashGroupsPerTick = 1024;
+  static constexpr size_t kVersionSlots = 1024;
+  // 时间轮中的一项。
+  static constexpr int64_t kExpireEntrySize = sizeof(Object*);
+
+  struct ObjectKey {
+    std::string_view operator()(const ObjectPtr& obj) const {
+      return obj->key();
+    }
+  };
+
+  // 值较大时交给后台线程释放，对象本身随后在锁内释放。
+  void FreeValueLater(Object* obj);
+  // 查找未过期的键，expired 表示键存在但已过期。
+  Object* FindObject(std::string_view key, size_t hash, bool& expired) const;
+  void EraseExpired(std::string_view key, size_t hash);
+  void AddExpire(Object* obj);
+  void RemoveExpire(Object* obj);
+  void OnExpired(Object* obj);
+  void MarkAllModified();
+  void ChargeObject(const Object* obj) { ChargeMemory(obj->MemoryUsage()); }
+  void RefundObject(const Object* obj) {
+    ChargeMemory(-static_cast<int64_t>(obj->MemoryUsage()));
+  }
+  // 哈希表扩容、迁移完成或清空后，按新的大小记账。
+  void SyncTableMemory();
+
+  mutable std::shared_mutex mutex_;
+  bool coarse_clock_;
+  bool lfu_;
+  size_t lfu_log_factor_;
+  int64_t lfu_decay_time_ms_;
+  bool huge_pages_;
+  size_t lazy_free_threshold_;
+  LazyFree& lazy_free_;
+  MemoryCounter& memory_;
+  FrequencySketch* sketch_;
+  // 对象、过期项和哈希表占用的字节数，以及还没有提交给 memory_ 的变化量。
+  int64_t used_memory_ = 0;
+  int64_t pending_memory_ = 0;
+  int64_t table_memory_ = 0;
+  // 先于 objects_ 构造、后于 objects_ 析构。slab 头记录了分配器的地址，
+  // 异步清空时整个分配器随对象一起交给后台线程。
+  std::unique_ptr<SlabAllocator> allocator_;
+  HashTable<ObjectPtr, ObjectKey> objects_;
+  expire::TimeWheel<expire::UnixTime, Object*> unix_tw_;
+  expire::TimeWheel<expire::BootTime, Object*> boot_tw_;
+  // 访问时发现已过期而删除的键数。
+  size_t lazy_expired_ = 0;
+  uint32_t versions_[kVersionSlots] = {};
+};
+
+}  // namespace libcache::db
+
+#endif  // LIBCACHE_SRC_DB_SHARD_HPP_
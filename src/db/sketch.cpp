@@ -0,0 +1,63 @@
+#include "sketch.hpp"
+
+using std::make_unique;
+using std::memory_order_relaxed;
+
+namespace libcache::db {
+
+FrequencySketch::FrequencySketch(size_t width) {
+  while ((size_t(1) << bits_) < width) {
+    bits_++;
+  }
+  sample_size_ = this->width() * kSampleFactor;
+  counters_ = make_unique<std::atomic<uint8_t>[]>(kDepth << bits_);
+}
+
+void FrequencySketch::Increment(size_t hash) {
+  bool added = false;
+  for (size_t row = 0; row < kDepth; row++) {
+    auto& counter = counters_[Index(hash, row)];
+    auto count = counter.load(memory_order_relaxed);
+    if (count < kMaxCount) {
+      counter.store(count + 1, memory_order_relaxed);
+      added = true;
+    }
+  }
+  // 热键的计数器都已计满时不再写共享的 additions_。
+  if (!added) {
+    return;
+  }
+  if (additions_.fetch_add(1, memory_order_relaxed) + 1 == sample_size_) {
+    Age();
+  }
+}
+
+uint8_t FrequencySketch::Estimate(size_t hash) const {
+  uint8_t estimate = kMaxCount;
+  for (size_t row = 0; row < kDepth; row++) {
+    auto count = counters_[Index(hash, row)].load(memory_order_relaxed);
+    if (count < estimate) {
+      estimate = count;
+    }
+  }
+  return estimate;
+}
+
+// 每行用不同的种子重新混合哈希值，取高位作为列号。
+size_t FrequencySketch::Index(size_t hash, size_t row) const {
+  static constexpr uint64_t kSeeds[kDepth] = {
+      0xc3a5c85c97cb3127, 0xb492b66fbe98f273, 0x9ae16a3b2f90404f,
+      0xcbf29ce484222325};
+  uint64_t mixed = (hash ^ kSeeds[row]) * 0x9e3779b97f4a7c15;
+  return (row << bits_) + (bits_ > 0 ? mixed >> (64 - bits_) : 0);
+}
+
+void FrequencySketch::Age() {
+  for (size_t i = 0; i < (kDepth << bits_); i++) {
+    auto count = counters_[i].load(memory_order_relaxed);
+    counters_[i].store(count / 2, memory_order_relaxed);
+  }
+  additions_.store(sample_size_ / 2, memory_order_relaxed);
+}
+
+}  // namespace libcache::db
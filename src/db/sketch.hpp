@@ -0,0 +1,41 @@
+#ifndef LIBCACHE_SRC_DB_SKETCH_HPP_
+#define LIBCACHE_SRC_DB_SKETCH_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace libcache::db {
+
+// TinyLFU 的 count-min sketch：kDepth 行计数器，键在每行按哈希值对应一个
+// 计数器，估计值取各行的最小值。计数器上限 kMaxCount，累计加 1 的次数达到
+// 宽度的 kSampleFactor 倍时全部减半，频率随时间老化。
+// 计数器是 relaxed 的原子变量，读命令在共享锁下并发加 1 时可能丢失一次，
+// 对估计没有影响。
+class FrequencySketch {
+ public:
+  // width 向上取整到 2 的幂，通常取键数的估计值。
+  explicit FrequencySketch(size_t width);
+
+  void Increment(size_t hash);
+  uint8_t Estimate(size_t hash) const;
+  size_t width() const { return size_t(1) << bits_; }
+
+ private:
+  static constexpr size_t kDepth = 4;
+  static constexpr uint8_t kMaxCount = 15;
+  static constexpr size_t kSampleFactor = 10;
+
+  size_t Index(size_t hash, size_t row) const;
+  void Age();
+
+  int bits_ = 0;
+  size_t sample_size_;
+  std::atomic<size_t> additions_ = 0;
+  std::unique_ptr<std::atomic<uint8_t>[]> counters_;
+};
+
+}  // namespace libcache::db
+
+#endif  // LIBCACHE_SRC_DB_SKETCH_HPP_
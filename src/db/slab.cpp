@@ -0,0 +1,241 @@
+#include "slab.hpp"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+using std::bad_alloc;
+using std::max;
+
+namespace libcache::db {
+
+namespace {
+
+constexpr size_t kClassSizes[] = {32,  48,  64,  80,  96,  112, 128,
+                                  160, 192, 224, 256, 320, 384, 448,
+                                  512, 640, 768, 896, 1024};
+
+// slab 头之后按 64 字节对齐开始存放块。
+constexpr size_t kHeaderSize = 64;
+
+}  // namespace
+
+struct SlabAllocator::Slab {
+  SlabAllocator* owner;
+  Slab* prev;
+  Slab* next;
+  void* free_list;
+  uint32_t index;
+  uint32_t used;
+  // 已经切出过的块数，之后的块按顺序分配。
+  uint32_t carved;
+};
+
+static_assert(sizeof(kClassSizes) / sizeof(kClassSizes[0]) ==
+              SlabAllocator::kClassCount);
+static_assert(kClassSizes[SlabAllocator::kClassCount - 1] ==
+              SlabAllocator::kMaxSize);
+
+void* SlabAllocator::Allocate(size_t size) {
+  assert(size <= kMaxSize);
+  auto index = ClassIndex(size);
+  auto& size_class = classes_[index];
+
+  auto slab = size_class.partial;
+  if (!slab) {
+    slab = NewSlab(index);
+    size_class.partial = slab;
+  }
+
+  void* ptr = slab->free_list;
+  if (ptr) {
+    slab->free_list = *static_cast<void**>(ptr);
+  } else {
+    ptr = reinterpret_cast<char*>(slab) + kHeaderSize +
+          slab->carved * kClassSizes[index];
+    slab->carved++;
+  }
+
+  slab->used++;
+  size_class.used_blocks++;
+  used_blocks_++;
+  if (slab->used == BlockCount(index)) {
+    size_class.partial = slab->next;
+    if (slab->next) {
+      slab->next->prev = nullptr;
+    }
+    slab->next = nullptr;
+  }
+  return ptr;
+}
+
+void SlabAllocator::Free(void* ptr) {
+  auto addr = reinterpret_cast<uintptr_t>(ptr) & ~(kSlabSize - 1);
+  auto slab = reinterpret_cast<Slab*>(addr);
+  slab->owner->FreeBlock(slab, ptr);
+}
+
+void SlabAllocator::FreeBlock(Slab* slab, void* ptr) {
+  auto& size_class = classes_[slab->index];
+
+  // 满的 slab 不在链表中，释放一块后重新挂回去。
+  if (slab->used == BlockCount(slab->index)) {
+    slab->prev = nullptr;
+    slab->next = size_class.partial;
+    if (slab->next) {
+      slab->next->prev = slab;
+    }
+    size_class.partial = slab;
+  }
+
+  *static_cast<void**>(ptr) = slab->free_list;
+  slab->free_list = ptr;
+  slab->used--;
+  size_class.used_blocks--;
+  used_blocks_--;
+  if (slab->used > 0) {
+    return;
+  }
+
+  // 空的 slab 交给其他大小级别复用。
+  if (slab->prev) {
+    slab->prev->next = slab->next;
+  } else {
+    size_class.partial = slab->next;
+  }
+  if (slab->next) {
+    slab->next->prev = slab->prev;
+  }
+  size_class.slabs--;
+  slab->next = free_slabs_;
+  free_slabs_ = slab;
+  free_slab_count_++;
+}
+
+void SlabAllocator::AddStats(MemoryStats& stats) const {
+  for (const auto& region : regions_) {
+    stats.regions++;
+    if (region.huge_page) {
+      stats.huge_page_regions++;
+    }
+  }
+  stats.free_slabs += free_slab_count_;
+
+  stats.slab_classes.resize(kClassCount);
+  for (size_t i = 0; i < kClassCount; i++) {
+    auto& class_stats = stats.slab_classes[i];
+    class_stats.block_size = kClassSizes[i];
+    class_stats.slabs += classes_[i].slabs;
+    class_stats.used_blocks += classes_[i].used_blocks;
+    class_stats.total_blocks += classes_[i].slabs * BlockCount(i);
+    stats.slabs += classes_[i].slabs;
+    stats.used_bytes += classes_[i].used_blocks * kClassSizes[i];
+  }
+  stats.slabs += free_slab_count_;
+}
+
+size_t SlabAllocator::BlockSize(size_t size) {
+  return kClassSizes[ClassIndex(size)];
+}
+
+size_t SlabAllocator::ClassIndex(size_t size) {
+  if (size <= 128) {
+    return (max(size, kClassSizes[0]) + 15) / 16 - 2;
+  }
+  if (size <= 256) {
+    return 6 + (size - 128 + 31) / 32;
+  }
+  if (size <= 512) {
+    return 10 + (size - 256 + 63) / 64;
+  }
+  return 14 + (size - 512 + 127) / 128;
+}
+
+size_t SlabAllocator::BlockCount(size_t index) {
+  return (kSlabSize - kHeaderSize) / kClassSizes[index];
+}
+
+SlabAllocator::Slab* SlabAllocator::NewSlab(size_t index) {
+  static_assert(sizeof(Slab) <= kHeaderSize);
+  Slab* slab = free_slabs_;
+  if (slab) {
+    free_slabs_ = slab->next;
+    free_slab_count_--;
+  } else {
+    if (region_next_ == region_end_) {
+      MapRegion();
+    }
+    slab = reinterpret_cast<Slab*>(region_next_);
+    region_next_ += kSlabSize;
+  }
+
+  slab->owner = this;
+  slab->prev = nullptr;
+  slab->next = nullptr;
+  slab->free_list = nullptr;
+  slab->index = index;
+  slab->used = 0;
+  slab->carved = 0;
+  classes_[index].slabs++;
+  return slab;
+}
+
+// 优先使用预留的大页，失败时申请普通页并建议内核使用透明大页。
+// 普通页多申请一个区域再裁剪，保证区域按 2MB 对齐。
+void SlabAllocator::MapRegion() {
+  void* addr = MAP_FAILED;
+  bool huge_page = false;
+#ifdef MAP_HUGETLB
+  if (huge_pages_) {
+    addr = mmap(nullptr, kRegionSize, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    huge_page = addr != MAP_FAILED;
+  }
+#endif
+
+  if (addr == MAP_FAILED) {
+    void* raw = mmap(nullptr, kRegionSize * 2, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+      throw bad_alloc();
+    }
+    auto begin = reinterpret_cast<uintptr_t>(raw);
+    auto aligned = (begin + kRegionSize - 1) & ~(kRegionSize - 1);
+    if (aligned > begin) {
+      munmap(raw, aligned - begin);
+    }
+    auto end = aligned + kRegionSize;
+    if (begin + kRegionSize * 2 > end) {
+      munmap(reinterpret_cast<void*>(end), begin + kRegionSize * 2 - end);
+    }
+    addr = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    if (huge_pages_) {
+      huge_page = madvise(addr, kRegionSize, MADV_HUGEPAGE) == 0;
+    }
+#endif
+  }
+
+  regions_.push_back({addr, huge_page});
+  region_next_ = static_cast<char*>(addr);
+  region_end_ = region_next_ + kRegionSize;
+}
+
+void SlabAllocator::Release() {
+  assert(used_blocks_ == 0);
+  for (const auto& region : regions_) {
+    munmap(region.addr, kRegionSize);
+  }
+  regions_.clear();
+  for (auto& size_class : classes_) {
+    size_class = SizeClass{};
+  }
+  region_next_ = nullptr;
+  region_end_ = nullptr;
+  free_slabs_ = nullptr;
+  free_slab_count_ = 0;
+}
+
+}  // namespace libcache::db
@@ -0,0 +1,77 @@
+#ifndef LIBCACHE_SRC_DB_SLAB_HPP_
+#define LIBCACHE_SRC_DB_SLAB_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "libcache/stats.hpp"
+
+namespace libcache::db {
+
+// 按大小分级的 slab 分配器，每个 Shard 一个，调用方需持有 Shard 的锁。
+// 内存以 2MB 的区域向系统申请，区域切成 64KB 的 slab，一个 slab 只存放一种
+// 大小的块。slab 按 64KB 对齐，Free 由地址找到 slab 头，不需要知道分配器。
+class SlabAllocator {
+ public:
+  static constexpr size_t kClassCount = 19;
+  static constexpr size_t kMaxSize = 1024;
+  static constexpr size_t kSlabSize = 64 * 1024;
+  static constexpr size_t kRegionSize = 2 * 1024 * 1024;
+
+  explicit SlabAllocator(bool huge_pages) : huge_pages_(huge_pages) {}
+  ~SlabAllocator() { Release(); }
+
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+  // size 不能超过 kMaxSize，内存不足时抛出 std::bad_alloc。
+  void* Allocate(size_t size);
+  static void Free(void* ptr);
+  // Allocate(size) 实际占用的块大小。
+  static size_t BlockSize(size_t size);
+
+  // 所有块都已释放时把区域还给系统。
+  void ReleaseIfEmpty() {
+    if (used_blocks_ == 0) {
+      Release();
+    }
+  }
+
+  void AddStats(MemoryStats& stats) const;
+
+ private:
+  struct Slab;
+  struct SizeClass {
+    // 还有空闲块的 slab 组成的双向链表。
+    Slab* partial = nullptr;
+    size_t slabs = 0;
+    size_t used_blocks = 0;
+  };
+  struct Region {
+    void* addr;
+    bool huge_page;
+  };
+
+  static size_t ClassIndex(size_t size);
+  static size_t BlockCount(size_t index);
+
+  Slab* NewSlab(size_t index);
+  void MapRegion();
+  void Release();
+  void FreeBlock(Slab* slab, void* ptr);
+
+  bool huge_pages_;
+  SizeClass classes_[kClassCount];
+  std::vector<Region> regions_;
+  // 当前区域中尚未切出的部分。
+  char* region_next_ = nullptr;
+  char* region_end_ = nullptr;
+  Slab* free_slabs_ = nullptr;
+  size_t free_slab_count_ = 0;
+  size_t used_blocks_ = 0;
+};
+
+}  // namespace libcache::db
+
+#endif  // LIBCACHE_SRC_DB_SLAB_HPP_
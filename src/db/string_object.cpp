@@ -1,49 +1,247 @@
 #include "string_object.hpp"
 
+#include <algorithm>
+#include <new>
+
 #include "snapshot.pb.h"
 #include "util/str.hpp"
 
 using libcache::util::StrToU64;
+using std::make_shared;
+using std::max;
+using std::move;
+using std::shared_ptr;
 using std::string;
+using std::string_view;
+using std::to_string;
 
 namespace libcache::db {
 
-Encoding StringObject::encoding() const {
+namespace {
+
+// 预先格式化好的共享整数，每个数占 4 个字符，只读。
+class SharedInts {
+ public:
+  SharedInts() {
+    for (int64_t i = 0; i < StringObject::kSharedIntCount; i++) {
+      auto str = to_string(i);
+      str.copy(digits_ + i * kWidth, str.size());
+    }
+  }
+
+  string_view Get(int64_t i64) const {
+    size_t size = i64 < 10 ? 1 : i64 < 100 ? 2 : i64 < 1000 ? 3 : 4;
+    return {digits_ + i64 * kWidth, size};
+  }
+
+ private:
+  static constexpr size_t kWidth = 4;
+
+  char digits_[StringObject::kSharedIntCount * kWidth] = {};
+};
+
+const SharedInts kSharedInts;
+
+}  // namespace
+
+StringObject* StringObject::New(SlabAllocator& allocator, string_view key,
+                                string_view value) {
+  int64_t i64 = 0;
+  if (ToInt64(value, i64)) {
+    return New(allocator, key, i64);
+  }
+
+  if (value.size() <= kEmbStrMaxSize) {
+    auto size = ValueOffset(key.size()) + max(value.size(), sizeof(int64_t));
+    auto obj = Allocate(allocator, key, Encoding::kEmbStr, size);
+    value.copy(obj->value_area(), value.size());
+    obj->set_value_size(value.size());
+    return obj;
+  }
+
+  return NewRaw(allocator, key, string(value));
+}
+
+StringObject* StringObject::New(SlabAllocator& allocator, string_view key,
+                                string&& value) {
+  if (value.size() <= kEmbStrMaxSize) {
+    return New(allocator, key, string_view(value));
+  }
+  return NewRaw(allocator, key, move(value));
+}
+
+StringObject* StringObject::NewRaw(SlabAllocator& allocator, string_view key,
+                                   string value) {
+  auto size = ValueOffset(key.size()) + sizeof(RawValue);
+  auto obj = Allocate(allocator, key, Encoding::kRaw, size);
+  new (obj->value_area()) RawValue(make_shared<string>(move(value)));
+  return obj;
+}
+
+StringObject* StringObject::New(SlabAllocator& allocator, string_view key,
+                                int64_t i64) {
+  if (!IsSharedInt(i64)) {
+    return NewPrivate(allocator, key, i64);
+  }
+
+  auto size = sizeof(StringObject) + key.size();
+  auto obj = Allocate(allocator, key, Encoding::kInt, size);
+  obj->set_shared();
+  obj->set_value_size(i64);
+  return obj;
+}
+
+StringObject* StringObject::NewPrivate(SlabAllocator& allocator,
+                                       string_view key, int64_t i64) {
+  auto size = ValueOffset(key.size()) + sizeof(i64);
+  auto obj = Allocate(allocator, key, Encoding::kInt, size);
+  obj->set_i64(i64);
+  return obj;
+}
+
+void StringObject::Delete(StringObject* obj) {
+  bool use_slab = UseSlab(obj->key().size());
+  obj->~StringObject();
+  if (use_slab) {
+    SlabAllocator::Free(obj);
+  } else {
+    ::operator delete(obj);
+  }
+}
+
+StringObject* StringObject::Allocate(SlabAllocator& allocator, string_view key,
+                                     Encoding encoding, size_t size) {
+  void* buf = UseSlab(key.size()) ? allocator.Allocate(size)
+                                  : ::operator new(size);
+  return new (buf) StringObject(key, encoding);
+}
+
+StringObject* StringObject::Unshare(SlabAllocator& allocator) const {
+  assert(shared());
+  auto obj = NewPrivate(allocator, key(), i64());
+  if (HasExpire()) {
+    obj->SetExpire(expire(), IsBootTime());
+  }
+  return obj;
+}
+
+StringObject::~StringObject() {
   if (IsRaw()) {
-    return Encoding::kRaw;
+    raw().~RawValue();
   }
-  return Encoding::kInt;
 }
 
-void StringObject::Update(const string& value) {
-  if (value.empty()) {
-    value_ = value;
-    return;
+// 只有规范形式的十进制整数才按 kInt 编码，保证 GET 能原样返回。
+bool StringObject::ToInt64(string_view value, int64_t& i64) {
+  if (value.empty() || value.size() > 20) {
+    return false;
   }
 
-  if (value[0] != '-') {
-    uint64_t u64 = 0;
-    bool is_int = StrToU64(value.c_str(), u64);
-    if (!is_int || u64 > INT64_MAX) {
-      value_ = value;
-    } else {
-      value_ = static_cast<int64_t>(u64);
-    }
-    return;
+  bool negative = value[0] == '-';
+  auto digits = negative ? value.substr(1) : value;
+  if (digits.empty() || (digits[0] == '0' && digits.size() > 1)) {
+    return false;
+  }
+  if (negative && digits == "0") {
+    return false;
   }
 
+  char buf[24] = {};
+  digits.copy(buf, digits.size());
   uint64_t u64 = 0;
-  bool is_int = StrToU64(value.c_str() + 1, u64);
-  if (!is_int || u64 > (1ULL << 63)) {
-    value_ = value;
-  } else {
-    value_ = -static_cast<int64_t>(u64);
+  if (!StrToU64(buf, u64)) {
+    return false;
+  }
+
+  if (!negative) {
+    if (u64 > INT64_MAX) {
+      return false;
+    }
+    i64 = static_cast<int64_t>(u64);
+    return true;
+  }
+
+  if (u64 > static_cast<uint64_t>(INT64_MAX) + 1) {
+    return false;
+  }
+  i64 = static_cast<int64_t>(0 - u64);
+  return true;
+}
+
+string StringObject::str() const {
+  if (!IsInt()) {
+    return string(view());
+  }
+  if (shared()) {
+    return string(kSharedInts.Get(i64()));
+  }
+  return to_string(i64());
+}
+
+shared_ptr<const string> StringObject::ref() const {
+  if (IsRaw()) {
+    return raw();
+  }
+  return make_shared<const string>(str());
+}
+
+// 还有句柄引用当前数据时，先复制一份再修改。
+string& StringObject::MutableRaw() {
+  assert(IsRaw());
+  auto& raw = this->raw();
+  if (raw.use_count() > 1) {
+    raw = make_shared<string>(*raw);
+  }
+  return *raw;
+}
+
+size_t StringObject::Append(string_view value) {
+  assert(IsRaw());
+  auto& raw = this->raw();
+  if (raw.use_count() > 1) {
+    auto copy = make_shared<string>();
+    copy->reserve(raw->size() + value.size());
+    copy->append(*raw);
+    raw = move(copy);
+  }
+  raw->append(value);
+  return raw->size();
+}
+
+// 按 New 中的分配大小计算，slab 中的对象按块大小计。kRaw 另外计入值的
+// 缓冲区，GetRef 返回的句柄还引用着的旧值不计。
+size_t StringObject::MemoryUsage() const {
+  size_t size = 0;
+  switch (encoding()) {
+    case Encoding::kInt:
+      size = shared() ? sizeof(StringObject) + key().size()
+                      : ValueOffset(key().size()) + sizeof(int64_t);
+      break;
+    case Encoding::kEmbStr:
+      size = ValueOffset(key().size()) +
+             max<size_t>(value_size(), sizeof(int64_t));
+      break;
+    case Encoding::kRaw:
+      size = ValueOffset(key().size()) + sizeof(RawValue);
+      break;
+  }
+  if (UseSlab(key().size())) {
+    size = SlabAllocator::BlockSize(size);
+  }
+
+  if (IsRaw() && raw()) {
+    size += kRawBlockSize;
+    // 超出短字符串优化的容量时，字符串的内容单独分配。
+    if (raw()->capacity() > string().capacity()) {
+      size += raw()->capacity() + 1;
+    }
   }
+  return size;
 }
 
-string StringObject::Serialize() {
+string StringObject::Serialize() const {
   auto obj = SnapshotObject();
-  obj.mutable_string_object()->set_value(string());
+  obj.mutable_string_object()->set_value(str());
   return obj.SerializeAsString();
 }
 
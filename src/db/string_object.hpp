@@ -2,42 +2,126 @@
 #define LIBCACHE_SRC_DB_STRING_OBJECT_HPP_
 
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <string>
-#include <variant>
+#include <string_view>
+#include <utility>
 
-#include "db.hpp"
+#include "object.hpp"
+#include "slab.hpp"
 
 namespace libcache::db {
 
+// 值存放在对象头和键之后：
+//   kInt    8 字节整数；
+//   kEmbStr 值本身，和对象头、键在同一次分配中；
+//   kRaw    引用计数的 std::string，GetRef 返回的句柄和对象共享同一份数据，
+//           有句柄存活时修改值会先复制一份（写时复制）。
+// 值区至少 8 字节。
+// 键不太长的对象从 Shard 的 slab 分配，否则使用 operator new。
+// [0, kSharedIntCount) 内的整数引用预先分配的只读整数池，对象没有值区，
+// 池下标记在 value_size 中；超出范围的修改需要先用 Unshare() 换成独占的副本。
 class StringObject : public Object {
  public:
-  StringObject(std::string key, ExpireHelper expire_helper,
-               const std::string& value)
-      : Object(std::move(key), std::move(expire_helper)) {
-    Update(value);
-  }
-  StringObject(std::string key, ExpireHelper expire_helper, int64_t i64)
-      : Object(std::move(key), std::move(expire_helper)) {
-    value_ = i64;
+  static constexpr size_t kEmbStrMaxSize = 44;
+  static constexpr int64_t kSharedIntCount = 10000;
+
+  static bool IsSharedInt(int64_t i64) {
+    return i64 >= 0 && i64 < kSharedIntCount;
   }
 
-  Type type() const override { return Type::kString; }
-  Encoding encoding() const override;
+  static StringObject* New(SlabAllocator& allocator, std::string_view key,
+                           std::string_view value);
+  // 按 kRaw 编码时直接移入 value 的缓冲区。
+  static StringObject* New(SlabAllocator& allocator, std::string_view key,
+                           std::string&& value);
+  static StringObject* New(SlabAllocator& allocator, std::string_view key,
+                           int64_t i64);
+  // 不论长度和内容都按 kRaw 编码。
+  static StringObject* NewRaw(SlabAllocator& allocator, std::string_view key,
+                              std::string value);
+  static void Delete(StringObject* obj);
+
+  // 复制出值不共享的对象，过期时间一并复制。
+  StringObject* Unshare(SlabAllocator& allocator) const;
+
+  bool IsRaw() const { return encoding() == Encoding::kRaw; }
+  bool IsInt() const { return encoding() == Encoding::kInt; }
+  bool IsEmbStr() const { return encoding() == Encoding::kEmbStr; }
+  bool IsShared() const { return shared(); }
 
-  const std::string& raw() const { return std::get<std::string>(value_); }
-  std::string& mut_raw() { return *std::get_if<std::string>(&value_); }
-  int64_t i64() const { return std::get<int64_t>(value_); }
-  void set_i64(int64_t i64) { value_ = i64; }
-  std::string str() const { return IsInt() ? std::to_string(i64()) : raw(); }
+  int64_t i64() const {
+    assert(IsInt());
+    if (shared()) {
+      return value_size();
+    }
+    int64_t i64;
+    memcpy(&i64, value_area(), sizeof(i64));
+    return i64;
+  }
+  // 共享整数只能原地修改成池内的值。
+  bool CanSetInt64(int64_t i64) const { return !shared() || IsSharedInt(i64); }
+  void set_i64(int64_t i64) {
+    assert(IsInt() && CanSetInt64(i64));
+    if (shared()) {
+      set_value_size(i64);
+      return;
+    }
+    memcpy(value_area(), &i64, sizeof(i64));
+  }
+  // kRaw 和 kEmbStr 编码的值。
+  std::string_view view() const {
+    assert(!IsInt());
+    if (IsEmbStr()) {
+      return {value_area(), value_size()};
+    }
+    return *raw();
+  }
+  std::string str() const;
+  // 只读的值句柄，kRaw 不复制数据。
+  std::shared_ptr<const std::string> ref() const;
 
-  bool IsRaw() const { return std::get_if<std::string>(&value_); }
-  bool IsInt() const { return std::get_if<int64_t>(&value_); }
+  // 取走 kRaw 编码的值，用于在锁外释放，之后对象只能销毁。
+  std::shared_ptr<std::string> TakeRaw() {
+    assert(IsRaw());
+    return std::move(raw());
+  }
 
-  void Update(const std::string& value);
-  std::string Serialize() override;
+  // kRaw 编码的值的可写引用，有句柄共享时先复制一份。
+  std::string& MutableRaw();
+  // 只有 kRaw 可以原地追加。
+  size_t Append(std::string_view value);
+  size_t MemoryUsage() const;
+  std::string Serialize() const;
 
  private:
-  std::variant<std::string, int64_t> value_;
+  StringObject(std::string_view key, Encoding encoding)
+      : Object(Type::kString, encoding, key) {}
+  ~StringObject();
+
+  // 任何编码的值区都不超过 kEmbStrMaxSize，键长决定对象能否放进 slab。
+  static bool UseSlab(size_t key_size) {
+    return ValueOffset(key_size) + kEmbStrMaxSize <= SlabAllocator::kMaxSize;
+  }
+  static StringObject* Allocate(SlabAllocator& allocator, std::string_view key,
+                                Encoding encoding, size_t size);
+  static StringObject* NewPrivate(SlabAllocator& allocator,
+                                  std::string_view key, int64_t i64);
+  static bool ToInt64(std::string_view value, int64_t& i64);
+
+  using RawValue = std::shared_ptr<std::string>;
+  // make_shared 把引用计数和 std::string 放在同一次分配中。
+  static constexpr size_t kRawBlockSize =
+      2 * sizeof(void*) + sizeof(std::string);
+
+  RawValue& raw() {
+    return *std::launder(reinterpret_cast<RawValue*>(value_area()));
+  }
+  const RawValue& raw() const {
+    return *std::launder(reinterpret_cast<const RawValue*>(value_area()));
+  }
 };
 
 }  // namespace libcache::db
@@ -6,72 +6,23 @@
 
 namespace libcache::expire {
 
-class UnixTime;
-class BootTime;
+using Duration = std::chrono::duration<int64_t, std::milli>;
 
-class TimePoint {
+// 墙上时钟，用于 PEXPIREAT 等绝对过期时间。
+class UnixTime {
  public:
-  using Duration = std::chrono::duration<int64_t, std::milli>;
-
-  enum class Type {
-    kUnixTime,
-    kBootTime,
-  };
-
-  TimePoint(int64_t ms, uint64_t seq) : ms_(ms), seq_(seq) {}
-
-  int64_t ms() const { return ms_; }
-  virtual int64_t pttl() const = 0;
-
-  virtual Type type() const = 0;
-
-  virtual int64_t ToUnixTime() const = 0;
-  virtual int64_t ToBootTime() const = 0;
-
- protected:
-  uint64_t seq() const { return seq_; }
-
- private:
-  int64_t ms_;
-  uint64_t seq_;
-};
-
-class UnixTime : public TimePoint {
- public:
-  UnixTime(int64_t ms, uint64_t seq) : TimePoint(ms, seq) {}
-
-  bool operator==(const UnixTime& other) const {
-    return ms() == other.ms() && seq() == other.seq();
-  }
-  bool operator<(const UnixTime& other) const;
-
-  Type type() const override { return Type::kUnixTime; }
-
-  int64_t pttl() const override { return ms() - Now(); }
-
-  int64_t ToUnixTime() const override { return ms(); }
-  int64_t ToBootTime() const override;
-
   static int64_t Now();
+  static int64_t ToBootTime(int64_t ms);
 };
 
-class BootTime : public TimePoint {
+// 单调时钟，用于 PEXPIRE 等相对过期时间，不受系统时间调整影响。
+class BootTime {
  public:
-  BootTime(int64_t ms, uint64_t seq) : TimePoint(ms, seq) {}
-
-  bool operator==(const BootTime& other) const {
-    return ms() == other.ms() && seq() == other.seq();
-  }
-  bool operator<(const BootTime& other) const;
-
-  Type type() const override { return Type::kBootTime; }
-
-  int64_t pttl() const override { return ms() - Now(); }
-
-  int64_t ToUnixTime() const override;
-  int64_t ToBootTime() const override { return ms(); }
-
   static int64_t Now();
+  // 精度为内核 tick（通常 1~4ms）的单调时钟，读取开销比 Now() 小，
+  // 只用于访问时间等不要求精确的场合。
+  static int64_t NowCoarse();
+  static int64_t ToUnixTime(int64_t ms);
 };
 
 }  // namespace libcache::expire
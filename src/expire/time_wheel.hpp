@@ -1,66 +1,275 @@
 #ifndef LIBCACHE_SRC_EXPIRE_TIME_WHEEL_HPP_
 #define LIBCACHE_SRC_EXPIRE_TIME_WHEEL_HPP_
 
+#include <algorithm>
 #include <cassert>
-#include <functional>
-#include <map>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 #include "time_point.hpp"
 
 namespace libcache::expire {
 
-template <typename TP>
+// 嵌入在时间轮元素中的句柄，记录元素所在的槽和槽内下标。
+struct TimerHandle {
+  uint32_t slot = 0;
+  uint32_t index = 0;
+};
+
+// 分层时间轮，刻度为 tick_ms 毫秒，每层的槽数是 2 的幂，上一层的一个槽覆盖
+// 下一层的一整圈，低层转完一圈时把上一层对应槽的元素降级到低层。
+// T 是指针，元素通过 expire() 提供到期时间（按 Clock 计的毫秒数），通过
+// timer_handle() 记录位置，插入和删除都是 O(1)。
+// 时间轮只记录元素，到期后的处理由 Tick 的调用方决定。
+template <typename Clock, typename T>
 class TimeWheel {
  public:
-  using Callback = std::function<void()>;
+  TimeWheel(size_t slots_per_level, int64_t tick_ms);
 
-  explicit TimeWheel(size_t bucket_count) : buckets_(bucket_count) {
-    assert(bucket_count > 0);
-  }
+  size_t size() const { return size_; }
+  // 已经到期、等待 Tick 处理的元素数。
+  size_t due_size() const { return slots_.back().size(); }
 
-  TP Add(int64_t ms, Callback callback);
-  void Remove(const TP& tp);
-  void Tick();
+  void Add(T value);
+  void Remove(T value);
+  void Clear();
+  // 推进到当前时间，到期的元素移入到期槽。
+  void Advance();
+  // 推进到当前时间，对至多 limit 个到期的元素调用 on_expired，调用前元素已经
+  // 移除。返回处理的元素数，没有处理完的留到下次。
+  template <typename Fn>
+  size_t Tick(Fn on_expired, size_t limit = SIZE_MAX);
+  // 随机采样：从 start 对应的槽和槽内位置开始，依次对至多 count 个元素调用
+  // fn，返回采样到的元素数。
+  template <typename Fn>
+  size_t Sample(size_t start, size_t count, Fn fn) const;
+  // 推进到当前时间，返回一个近似最早到期的元素，时间轮为空时返回 nullptr。
+  // 槽按到期槽、第 0 层、更高层的顺序查找，每层从当前位置的下一个槽绕一圈。
+  // 只有到期槽和第 0 层是按刻度排序的：第 0 层中绕过下一个上层边界的槽排在
+  // 上层的槽之前，却可能更晚到期；第 level 层的槽是降级前的桶，覆盖
+  // 2^(bits * level) 个刻度。从上次找到的槽继续查找，推进后从头开始，
+  // 均摊 O(1)。
+  T Front();
 
  private:
-  std::vector<std::map<TP, Callback>> buckets_;
-  size_t next_bucket_ = 0;
-  size_t next_seq_ = 1;
+  // 距离当前超过 2^kMaxBits 个刻度的元素先放在最高层，降级时再重新定位。
+  static constexpr int kMaxBits = 36;
+  // 到期槽处理完后，容量超过这个值就释放内存。
+  static constexpr size_t kDueKeepCapacity = 1024;
+
+  int64_t TickOf(int64_t at) const {
+    return at / tick_ms_ + (at % tick_ms_ > 0);
+  }
+  size_t SlotIndex(size_t level, int64_t tick) const {
+    return (level << bits_) + ((tick >> (bits_ * level)) & mask_);
+  }
+  size_t DueSlot() const { return slots_.size() - 1; }
+  // 槽在到期顺序中的位置：到期槽为 0，第 level 层当前位置之后的第 k 个槽为
+  // (level << bits_) + k，k 取 1 到 2^bits_。
+  size_t RankOf(size_t slot) const {
+    if (slot == DueSlot()) {
+      return 0;
+    }
+    size_t level = slot >> bits_;
+    int64_t k = (int64_t(slot) - (current_ >> (bits_ * level))) & mask_;
+    return (level << bits_) + (k == 0 ? mask_ + 1 : k);
+  }
+  size_t SlotOfRank(size_t rank) const {
+    if (rank == 0) {
+      return DueSlot();
+    }
+    size_t level = (rank - 1) >> bits_;
+    int64_t k = ((rank - 1) & mask_) + 1;
+    return (level << bits_) + (((current_ >> (bits_ * level)) + k) & mask_);
+  }
+
+  void Place(T value);
+  void Append(size_t slot, T value);
+  void Cascade(size_t level);
+  void MoveToDue(size_t slot);
+
+  int bits_ = 1;
+  int64_t mask_;
+  size_t levels_;
+  int64_t tick_ms_;
+  // 已经处理到的刻度。
+  int64_t current_;
+  size_t size_ = 0;
+  // Front 上次找到的槽的位置，比它靠前的槽都是空的。
+  size_t front_ = 0;
+  // 各层的槽依次排列，最后一个槽存放已经到期、等待处理的元素。
+  std::vector<std::vector<T>> slots_;
 };
 
-template <typename TP>
-inline TP TimeWheel<TP>::Add(int64_t at, Callback callback) {
-  size_t index = at % buckets_.size();
-  auto& bucket = buckets_[index];
-  TP tp(at, next_seq_++);
-  bucket[tp] = std::move(callback);
-  return tp;
+template <typename Clock, typename T>
+TimeWheel<Clock, T>::TimeWheel(size_t slots_per_level, int64_t tick_ms)
+    : tick_ms_(tick_ms), current_(Clock::Now() / tick_ms) {
+  assert(slots_per_level > 0 && tick_ms > 0);
+  while ((size_t(1) << bits_) < slots_per_level) {
+    bits_++;
+  }
+  mask_ = (int64_t(1) << bits_) - 1;
+  levels_ = (kMaxBits + bits_ - 1) / bits_;
+  slots_.resize((levels_ << bits_) + 1);
+}
+
+template <typename Clock, typename T>
+inline void TimeWheel<Clock, T>::Add(T value) {
+  Place(value);
+  size_++;
+}
+
+template <typename Clock, typename T>
+inline void TimeWheel<Clock, T>::Remove(T value) {
+  auto& handle = value->timer_handle();
+  auto* slot = &slots_[handle.slot];
+  // 整槽移入到期槽的元素，句柄中仍是原来的槽，下标不变。
+  if (handle.index >= slot->size() || (*slot)[handle.index] != value) {
+    slot = &slots_[DueSlot()];
+  }
+  assert(handle.index < slot->size() && (*slot)[handle.index] == value);
+  T last = slot->back();
+  (*slot)[handle.index] = last;
+  last->timer_handle().index = handle.index;
+  slot->pop_back();
+  size_--;
 }
 
-template <typename TP>
-inline void TimeWheel<TP>::Remove(const TP& tp) {
-  size_t index = tp.ms() % buckets_.size();
-  auto& bucket = buckets_[index];
-  auto n = bucket.erase(tp);
-  assert(n);
+template <typename Clock, typename T>
+inline void TimeWheel<Clock, T>::Clear() {
+  for (auto& slot : slots_) {
+    std::vector<T>().swap(slot);
+  }
+  size_ = 0;
+  front_ = 0;
 }
 
-template <typename TP>
-inline void TimeWheel<TP>::Tick() {
-  auto& bucket = buckets_[next_bucket_];
-  next_bucket_ = (next_bucket_ + 1) % buckets_.size();
+template <typename Clock, typename T>
+template <typename Fn>
+inline size_t TimeWheel<Clock, T>::Tick(Fn on_expired, size_t limit) {
+  Advance();
+  auto& due = slots_[DueSlot()];
+  size_t count = 0;
+  while (!due.empty() && count < limit) {
+    T value = due.back();
+    due.pop_back();
+    size_--;
+    count++;
+    on_expired(value);
+  }
+  if (due.empty() && due.capacity() > kDueKeepCapacity) {
+    std::vector<T>().swap(due);
+  }
+  return count;
+}
 
-  while (!bucket.empty()) {
-    auto front = bucket.begin();
-    const TP& tp = front->first;
-    if (tp.pttl() > 0) {
+template <typename Clock, typename T>
+template <typename Fn>
+inline size_t TimeWheel<Clock, T>::Sample(size_t start, size_t count,
+                                          Fn fn) const {
+  size_t sampled = 0;
+  size_t offset = start / slots_.size();
+  for (size_t i = 0; i < slots_.size() && sampled < count; i++) {
+    const auto& slot = slots_[(start + i) % slots_.size()];
+    for (size_t j = 0; j < slot.size() && sampled < count; j++) {
+      fn(slot[(offset + j) % slot.size()]);
+      sampled++;
+    }
+  }
+  return sampled;
+}
+
+template <typename Clock, typename T>
+T TimeWheel<Clock, T>::Front() {
+  Advance();
+  if (size_ == 0) {
+    return nullptr;
+  }
+  for (; front_ < slots_.size(); front_++) {
+    const auto& slot = slots_[SlotOfRank(front_)];
+    if (!slot.empty()) {
+      return slot.back();
+    }
+  }
+  assert(false);
+  return nullptr;
+}
+
+template <typename Clock, typename T>
+void TimeWheel<Clock, T>::Advance() {
+  int64_t now = Clock::Now() / tick_ms_;
+  if (current_ < now) {
+    front_ = 0;
+  }
+  while (current_ < now) {
+    // 除了到期槽都是空的，不需要逐个刻度推进。
+    if (size_ == due_size()) {
+      current_ = now;
       break;
     }
+    current_++;
+    for (size_t level = 1; level < levels_; level++) {
+      if (current_ & ((int64_t(1) << (bits_ * level)) - 1)) {
+        break;
+      }
+      Cascade(level);
+    }
+    MoveToDue(SlotIndex(0, current_));
+  }
+}
 
-    const Callback& callback = front->second;
-    callback();
+// 按到期刻度与当前刻度的差值选层，层内按到期刻度在这一层的位选槽。
+template <typename Clock, typename T>
+void TimeWheel<Clock, T>::Place(T value) {
+  int64_t tick = TickOf(value->expire());
+  if (tick <= current_) {
+    Append(DueSlot(), value);
+    return;
+  }
+
+  int64_t delta = tick - current_;
+  size_t level = 0;
+  while (level + 1 < levels_ && (delta >> (bits_ * (level + 1))) != 0) {
+    level++;
+  }
+  if ((delta >> (bits_ * levels_)) != 0) {
+    tick = current_ + (int64_t(1) << (bits_ * levels_)) - 1;
+  }
+  Append(SlotIndex(level, tick), value);
+}
+
+template <typename Clock, typename T>
+inline void TimeWheel<Clock, T>::Append(size_t slot, T value) {
+  auto& handle = value->timer_handle();
+  handle.slot = slot;
+  handle.index = slots_[slot].size();
+  slots_[slot].push_back(value);
+  front_ = std::min(front_, RankOf(slot));
+}
+
+template <typename Clock, typename T>
+void TimeWheel<Clock, T>::Cascade(size_t level) {
+  auto slot = std::move(slots_[SlotIndex(level, current_)]);
+  slots_[SlotIndex(level, current_)].clear();
+  for (auto value : slot) {
+    Place(value);
+  }
+}
+
+// 到期槽为空时直接交换，不逐个修改句柄，大量键同时到期时推进是 O(1) 的。
+template <typename Clock, typename T>
+void TimeWheel<Clock, T>::MoveToDue(size_t index) {
+  auto& slot = slots_[index];
+  auto& due = slots_[DueSlot()];
+  if (due.empty()) {
+    due.swap(slot);
+    return;
+  }
+  for (auto value : slot) {
+    Append(DueSlot(), value);
   }
+  slot.clear();
 }
 
 }  // namespace libcache::expire
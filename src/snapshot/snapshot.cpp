@@ -1,10 +1,6 @@
 #include "snapshot.hpp"
 
-#include "db/string_object.hpp"
-
-using std::make_shared;
 using std::move;
-using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
 
@@ -32,27 +28,17 @@ Status SnapshotReader::Open(const string& path,
   return Status::OK();
 }
 
-Status SnapshotReader::Read(shared_ptr<db::Object>& obj,
-                            db::Object::ExpireHelper helper) {
+Status SnapshotReader::Read(snapshot::Object& obj) {
   string record;
   auto status = record_reader_->Read(record);
   if (status.error()) {
     return status;
   }
 
-  snapshot::Object snapshot_obj;
-  auto ok = snapshot_obj.ParseFromString(record);
+  auto ok = obj.ParseFromString(record);
   if (!ok) {
     return Status::Corrupt();
   }
-
-  if (snapshot_obj.has_string_object()) {
-    auto obj = make_shared<db::StringObject>(
-        snapshot_obj.key(), move(helper), snapshot_obj.string_object().value());
-    obj->Parse(snapshot_obj);
-    return Status::OK();
-  }
-
   return Status::OK();
 }
 
@@ -15,8 +15,7 @@ class SnapshotReader {
   static Status Open(const std::string& path,
                      std::unique_ptr<SnapshotReader>& reader);
 
-  Status Read(std::shared_ptr<db::Object>& obj,
-              db::Object::ExpireHelper helper);
+  Status Read(snapshot::Object& obj);
 
  private:
   SnapshotReader(std::unique_ptr<RecordReader> record_reader)
@@ -30,7 +29,7 @@ class SnapshotWriter {
   static Status Open(const std::string& path,
                      std::unique_ptr<SnapshotWriter>& writer);
 
-  Status Append(const std::string& key, std::shared_ptr<db::Object> obj) {
+  Status Append(const db::Object* obj) {
     return record_writer_->Append(obj->Serialize());
   }
 
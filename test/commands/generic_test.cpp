@@ -0,0 +1,436 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <libcache/libcache.hpp>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::to_string;
+using std::chrono::milliseconds;
+using std::this_thread::sleep_for;
+
+namespace libcache {
+
+TEST(TestGeneric, ActiveExpire) {
+  Options options;
+  options.timer_interval = 10;
+  options.db_options_array[0].expire_cycle_budget_us = 100;
+  auto cache = Cache::New(options);
+
+  constexpr size_t kKeyCount = 100000;
+  for (size_t i = 0; i < kKeyCount; i++) {
+    cache->Set("key" + to_string(i), "value", 0, PX(20));
+  }
+  cache->Set("persistent", "value");
+  cache->Set("later", "value", 0, EX(3600));
+
+  for (int i = 0; i < 500; i++) {
+    if (cache->ExpireStats().expired_keys == kKeyCount) {
+      break;
+    }
+    sleep_for(milliseconds(10));
+  }
+  auto stats = cache->ExpireStats();
+  EXPECT_EQ(stats.expired_keys, kKeyCount);
+  EXPECT_EQ(stats.volatile_keys, 1);
+  EXPECT_EQ(stats.backlog, 0);
+  EXPECT_GT(stats.cycles, 1);
+  EXPECT_EQ(cache->Get("persistent").value(), "value");
+  EXPECT_EQ(cache->Get("later").value(), "value");
+
+  delete cache;
+}
+
+TEST(TestGeneric, LazyExpire) {
+  Options options;
+  options.timer_interval = 3600 * 1000;
+  auto cache = Cache::New(options);
+
+  cache->Set("read", "value", 0, PX(10));
+  cache->Set("write", "value", 0, PX(10));
+  cache->Set("later", "value", 0, EX(3600));
+  EXPECT_EQ(cache->ExpireStats().volatile_keys, 3);
+  sleep_for(milliseconds(20));
+
+  EXPECT_FALSE(cache->Get("read").has_value());
+  EXPECT_EQ(cache->IncrBy("write", 1), 1);
+  EXPECT_EQ(cache->Pttl("write"), -1);
+
+  auto stats = cache->ExpireStats();
+  EXPECT_EQ(stats.lazy_expired_keys, 2);
+  EXPECT_EQ(stats.volatile_keys, 1);
+  EXPECT_EQ(stats.expired_keys, 0);
+
+  delete cache;
+}
+
+TEST(TestGeneric, DelExists) {
+  // 定时器不会在测试期间主动删除到期的键。
+  Options options;
+  options.timer_interval = 60 * 1000;
+  auto cache = Cache::New(options);
+
+  for (int i = 0; i < 100; i++) {
+    cache->Set("key" + to_string(i), "value", 0, EX(3600));
+  }
+  cache->Set("expired", "value", 0, PX(1));
+  sleep_for(milliseconds(5));
+
+  EXPECT_EQ(cache->Exists({"key0", "key0", "key1", "expired", "missing"}), 3);
+  // Exists 遇到的已过期的键立即删除。
+  EXPECT_EQ(cache->ExpireStats().lazy_expired_keys, 1);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 100; i += 2) {
+    keys.push_back("key" + to_string(i));
+  }
+  keys.push_back("key0");
+  keys.push_back("expired");
+  EXPECT_EQ(cache->Del(keys), 50);
+  EXPECT_EQ(cache->Exists(keys), 0);
+  EXPECT_EQ(cache->Exists({"key1", "key99"}), 2);
+  EXPECT_EQ(cache->ExpireStats().volatile_keys, 50);
+
+  delete cache;
+}
+
+// 等后台线程把交给它的对象释放完，返回累计释放的对象数。
+static size_t WaitLazyFree(Cache* cache) {
+  for (int i = 0; i < 500 && cache->MemoryStats().lazy_free_pending > 0; i++) {
+    sleep_for(milliseconds(10));
+  }
+  auto stats = cache->MemoryStats();
+  EXPECT_EQ(stats.lazy_free_pending, 0);
+  return stats.lazy_freed_objects;
+}
+
+TEST(TestGeneric, Unlink) {
+  Options options;
+  options.db_options_array[0].lazy_free_threshold = 16;
+  auto cache = Cache::New(options);
+
+  cache->Set("big", std::string(1000, 'a'));
+  cache->Set("small", "value");
+  auto ref = cache->GetRef("big");
+  auto freed = WaitLazyFree(cache);
+
+  EXPECT_EQ(cache->Unlink({"big", "small", "missing"}), 2);
+  EXPECT_FALSE(cache->Get("big").has_value());
+  EXPECT_FALSE(cache->Get("small").has_value());
+  // 只有超过 lazy_free_threshold 的值交给后台线程。
+  EXPECT_EQ(WaitLazyFree(cache), freed + 1);
+  // 后台释放不影响仍在使用的句柄。
+  EXPECT_EQ(*ref, std::string(1000, 'a'));
+
+  delete cache;
+}
+
+TEST(TestGeneric, FlushAsync) {
+  auto cache = Cache::New();
+
+  for (int i = 0; i < 10000; i++) {
+    cache->Set("key" + to_string(i), std::string(100, 'a'), 0, EX(3600));
+  }
+  auto freed = WaitLazyFree(cache);
+  cache->FlushDB(FlushMode::kAsync);
+  EXPECT_FALSE(cache->Get("key0").has_value());
+  EXPECT_EQ(cache->ExpireStats().volatile_keys, 0);
+  EXPECT_EQ(cache->MemoryStats().used_memory, 0);
+  // 每个分片摘下的对象和分配器整体交给后台线程释放。
+  EXPECT_EQ(WaitLazyFree(cache), freed + DBOptions().shard_count);
+
+  cache->Set("key0", "value");
+  EXPECT_EQ(cache->Get("key0").value(), "value");
+  cache->FlushAll(FlushMode::kAsync);
+  EXPECT_FALSE(cache->Get("key0").has_value());
+
+  delete cache;
+}
+
+TEST(TestGeneric, MemoryStats) {
+  // 只有一个分片，两个键共用一张哈希表。
+  Options options;
+  options.db_options_array[0].shard_count = 1;
+  auto cache = Cache::New(options);
+
+  cache->Set("a", "1");
+  auto base = cache->MemoryStats().used_memory;
+  EXPECT_GT(base, 0);
+
+  cache->Set("key", std::string(10000, 'a'));
+  auto used = cache->MemoryStats().used_memory;
+  EXPECT_GT(used, base + 10000);
+  // 过期时间在时间轮中占一项。
+  cache->Expire("key", 3600);
+  EXPECT_EQ(cache->MemoryStats().used_memory, used + sizeof(void*));
+  cache->Persist("key");
+  EXPECT_EQ(cache->MemoryStats().used_memory, used);
+  cache->Append("key", std::string(10000, 'b'));
+  EXPECT_GE(cache->MemoryStats().used_memory, used + 10000);
+
+  cache->Del({"key"});
+  auto stats = cache->MemoryStats();
+  EXPECT_EQ(stats.used_memory, base);
+  EXPECT_GT(stats.peak_memory, base + 20000);
+  EXPECT_GT(stats.fragmentation_ratio, 0);
+
+  delete cache;
+}
+
+TEST(TestGeneric, MaxMemory) {
+  constexpr size_t kMaxMemory = 1024 * 1024;
+  Options options;
+  options.db_options_array[0].maxmemory = kMaxMemory;
+  auto cache = Cache::New(options);
+
+  auto status = Status::OK();
+  size_t count = 0;
+  while (count < 10000) {
+    cache->Set(status, "key" + to_string(count), std::string(1000, 'a'));
+    if (status.error()) {
+      break;
+    }
+    count++;
+  }
+  EXPECT_EQ(status.code(), kOutOfMemory);
+  EXPECT_LT(count, 10000);
+  // 分片攒够一批才提交，计数最多滞后 分片数 * 4KB。
+  auto stats = cache->MemoryStats();
+  EXPECT_EQ(stats.maxmemory, kMaxMemory);
+  EXPECT_LE(stats.used_memory, kMaxMemory + 16 * 4096 + 2048);
+
+  // 读和删除不受限制，删除后可以继续写。
+  EXPECT_EQ(cache->Get("key0").value(), std::string(1000, 'a'));
+  cache->IncrBy(status, "counter", 1);
+  EXPECT_EQ(status.code(), kOutOfMemory);
+  EXPECT_THROW(cache->Set("key0", "value"), Exception);
+  cache->FlushDB();
+  cache->Set(status, "key0", "value");
+  EXPECT_TRUE(status.ok());
+
+  delete cache;
+}
+
+TEST(TestGeneric, MaxMemoryAllDBs) {
+  Options options;
+  options.db_options_array.resize(2);
+  options.maxmemory = 1024 * 1024;
+  auto cache = Cache::New(options);
+
+  auto status = Status::OK();
+  for (size_t i = 0; i < 10000 && status.ok(); i++) {
+    cache->Set(status, i % 2, "key" + to_string(i), std::string(1000, 'a'));
+  }
+  EXPECT_EQ(status.code(), kOutOfMemory);
+  auto used = cache->MemoryStats(0).used_memory +
+              cache->MemoryStats(1).used_memory;
+  EXPECT_LE(used, options.maxmemory + 2 * 16 * 4096 + 2048);
+  EXPECT_GT(used, options.maxmemory / 2);
+
+  delete cache;
+}
+
+TEST(TestGeneric, EvictAllKeysLRU) {
+  constexpr size_t kMaxMemory = 1024 * 1024;
+  Options options;
+  options.db_options_array[0].maxmemory = kMaxMemory;
+  options.db_options_array[0].eviction_policy = EvictionPolicy::kAllKeysLRU;
+  options.db_options_array[0].access_clock = ClockMode::kPrecise;
+  auto cache = Cache::New(options);
+
+  for (int i = 0; i < 100; i++) {
+    cache->Set("hot" + to_string(i), std::string(1000, 'a'));
+  }
+  // 写入的数据是上限的 5 倍，热键一直被访问，不会被淘汰。
+  for (int i = 0; i < 5000; i++) {
+    if (i % 100 == 0) {
+      sleep_for(milliseconds(1));
+      for (int j = 0; j < 100; j++) {
+        cache->Get("hot" + to_string(j));
+      }
+    }
+    cache->Set("cold" + to_string(i), std::string(1000, 'a'));
+  }
+
+  auto stats = cache->MemoryStats();
+  EXPECT_GT(stats.evicted_keys, 0);
+  EXPECT_LE(stats.used_memory, kMaxMemory + 64 * 1024);
+  int hot = 0;
+  for (int i = 0; i < 100; i++) {
+    hot += cache->Exists({"hot" + to_string(i)});
+  }
+  EXPECT_GE(hot, 95);
+  EXPECT_TRUE(cache->Get("cold4999").has_value());
+
+  delete cache;
+}
+
+TEST(TestGeneric, EvictVolatileLRU) {
+  constexpr size_t kMaxMemory = 1024 * 1024;
+  Options options;
+  options.db_options_array[0].maxmemory = kMaxMemory;
+  options.db_options_array[0].eviction_policy = EvictionPolicy::kVolatileLRU;
+  auto cache = Cache::New(options);
+
+  for (int i = 0; i < 500; i++) {
+    cache->Set("persistent" + to_string(i), std::string(1000, 'a'));
+  }
+  for (int i = 0; i < 5000; i++) {
+    cache->Set("volatile" + to_string(i), std::string(1000, 'a'), 0, EX(3600));
+  }
+  // 只淘汰有过期时间的键。
+  EXPECT_GT(cache->MemoryStats().evicted_keys, 0);
+  for (int i = 0; i < 500; i++) {
+    EXPECT_TRUE(cache->Exists({"persistent" + to_string(i)}));
+  }
+
+  // 有过期时间的键都被淘汰后拒绝写入。
+  auto status = Status::OK();
+  for (int i = 500; i < 5000 && status.ok(); i++) {
+    cache->Set(status, "persistent" + to_string(i), std::string(1000, 'a'));
+  }
+  EXPECT_EQ(status.code(), kOutOfMemory);
+  EXPECT_EQ(cache->ExpireStats().volatile_keys, 0);
+
+  delete cache;
+}
+
+TEST(TestGeneric, EvictVolatileTTL) {
+  constexpr size_t kMaxMemory = 1024 * 1024;
+  Options options;
+  options.db_options_array[0].shard_count = 1;
+  options.db_options_array[0].maxmemory = kMaxMemory;
+  options.db_options_array[0].eviction_policy = EvictionPolicy::kVolatileTTL;
+  auto cache = Cache::New(options);
+
+  // 按随机顺序写入剩余时间不同的键，写入顺序不影响淘汰顺序。
+  constexpr int kVolatileKeys = 600;
+  std::vector<int> order(kVolatileKeys);
+  for (int i = 0; i < kVolatileKeys; i++) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(1));
+  for (int i : order) {
+    cache->Set("volatile" + to_string(i), std::string(1000, 'a'), 0,
+               EX(100 + i));
+  }
+  for (int i = 0; i < 500; i++) {
+    cache->Set("persistent" + to_string(i), std::string(1000, 'a'));
+  }
+
+  auto evicted_keys = cache->ExpireStats().evicted_keys;
+  EXPECT_GT(evicted_keys, 0);
+  EXPECT_EQ(evicted_keys, cache->MemoryStats().evicted_keys);
+  auto evicted = static_cast<int>(evicted_keys);
+  // 同一时刻写入的键按槽排序，这里第 1 层的每个槽覆盖 64 秒。
+  for (int i = 0; i < kVolatileKeys; i++) {
+    if (i < evicted - 64) {
+      EXPECT_FALSE(cache->Exists({"volatile" + to_string(i)}));
+    } else if (i >= evicted + 64) {
+      EXPECT_TRUE(cache->Exists({"volatile" + to_string(i)}));
+    }
+  }
+  for (int i = 0; i < 500; i++) {
+    EXPECT_TRUE(cache->Exists({"persistent" + to_string(i)}));
+  }
+
+  delete cache;
+}
+
+TEST(TestGeneric, ObjectFreq) {
+  auto cache = Cache::New();
+  cache->Set("key", "value");
+  auto status = Status::OK();
+  cache->ObjectFreq(status, "key");
+  EXPECT_EQ(status.code(), kNoLFUPolicy);
+  delete cache;
+
+  // log_factor 为 0 时每次访问都加 1。
+  Options options;
+  options.db_options_array[0].eviction_policy = EvictionPolicy::kAllKeysLFU;
+  options.db_options_array[0].lfu_log_factor = 0;
+  options.db_options_array[0].lfu_decay_time_ms = 10;
+  cache = Cache::New(options);
+  cache->Set("key", "value");
+  EXPECT_EQ(cache->ObjectFreq("key").value(), 5);
+  for (int i = 0; i < 100; i++) {
+    cache->Get("key");
+  }
+  EXPECT_EQ(cache->ObjectFreq("key").value(), 105);
+  // 覆盖写入沿用原来的频率。
+  cache->Set("key", "new value");
+  EXPECT_EQ(cache->ObjectFreq("key").value(), 105);
+  EXPECT_FALSE(cache->ObjectFreq("missing").has_value());
+
+  sleep_for(milliseconds(100));
+  auto freq = cache->ObjectFreq("key").value();
+  EXPECT_LE(freq, 105 - 8);
+  EXPECT_GE(freq, 105 - 12);
+  delete cache;
+}
+
+TEST(TestGeneric, EvictAllKeysLFU) {
+  constexpr size_t kMaxMemory = 1024 * 1024;
+  Options options;
+  options.db_options_array[0].maxmemory = kMaxMemory;
+  options.db_options_array[0].eviction_policy = EvictionPolicy::kAllKeysLFU;
+  auto cache = Cache::New(options);
+
+  for (int i = 0; i < 100; i++) {
+    cache->Set("hot" + to_string(i), std::string(1000, 'a'));
+    for (int j = 0; j < 20; j++) {
+      cache->Get("hot" + to_string(i));
+    }
+  }
+  // 只写一次的键再多也不会挤掉经常访问的键。
+  for (int i = 0; i < 5000; i++) {
+    cache->Set("scan" + to_string(i), std::string(1000, 'a'));
+  }
+
+  EXPECT_GT(cache->MemoryStats().evicted_keys, 0);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(cache->Exists({"hot" + to_string(i)}));
+  }
+
+  delete cache;
+}
+
+TEST(TestGeneric, AdmissionFilter) {
+  constexpr size_t kMaxMemory = 1024 * 1024;
+  Options options;
+  options.db_options_array[0].maxmemory = kMaxMemory;
+  options.db_options_array[0].eviction_policy = EvictionPolicy::kAllKeysLRU;
+  options.db_options_array[0].admission_filter = true;
+  auto cache = Cache::New(options);
+
+  for (int i = 0; i < 100; i++) {
+    cache->Set("hot" + to_string(i), std::string(1000, 'a'));
+    for (int j = 0; j < 20; j++) {
+      cache->Get("hot" + to_string(i));
+    }
+  }
+  // LRU 下扫描会挤掉所有热键，准入过滤把只写一次的新键挡在窗口里。
+  for (int i = 0; i < 5000; i++) {
+    cache->Set("scan" + to_string(i), std::string(1000, 'a'));
+  }
+
+  auto stats = cache->MemoryStats();
+  EXPECT_GT(stats.rejected_keys, 0);
+  EXPECT_LE(stats.rejected_keys, stats.evicted_keys);
+  int64_t hot_keys = 0;
+  for (int i = 0; i < 100; i++) {
+    hot_keys += cache->Exists({"hot" + to_string(i)});
+  }
+  EXPECT_GE(hot_keys, 90);
+  delete cache;
+
+  auto status = Status::OK();
+  options.db_options_array[0].eviction_policy = EvictionPolicy::kVolatileLRU;
+  cache = Cache::New(status, options);
+  EXPECT_EQ(status.code(), kInvalidOptions);
+  EXPECT_EQ(cache, nullptr);
+}
+
+}  // namespace libcache
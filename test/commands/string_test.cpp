@@ -2,8 +2,16 @@
 
 #include <chrono>
 #include <libcache/libcache.hpp>
+#include <string>
 #include <thread>
-
+#include <utility>
+#include <vector>
+
+using std::pair;
+using std::string;
+using std::to_string;
+using std::vector;
+using std::chrono::milliseconds;
 using std::chrono::seconds;
 using std::this_thread::sleep_for;
 
@@ -45,6 +53,185 @@ TEST(TestString, AppendWithExpire) {
   delete cache;
 }
 
+TEST(TestString, Encoding) {
+  auto cache = Cache::New();
+
+  cache->Set("int", "12345");
+  EXPECT_EQ(cache->ObjectEncoding("int"), Encoding::kInt);
+  EXPECT_EQ(cache->Get("int").value(), "12345");
+
+  cache->Set("padded", "007");
+  EXPECT_EQ(cache->ObjectEncoding("padded"), Encoding::kEmbStr);
+  EXPECT_EQ(cache->Get("padded").value(), "007");
+
+  cache->Set("short", std::string(44, 'a'));
+  EXPECT_EQ(cache->ObjectEncoding("short"), Encoding::kEmbStr);
+  cache->Set("long", std::string(45, 'a'));
+  EXPECT_EQ(cache->ObjectEncoding("long"), Encoding::kRaw);
+  EXPECT_EQ(cache->Get("long").value(), std::string(45, 'a'));
+
+  cache->Append("short", "b");
+  EXPECT_EQ(cache->ObjectEncoding("short"), Encoding::kRaw);
+  EXPECT_EQ(cache->Get("short").value(), std::string(44, 'a') + "b");
+
+  cache->Append("int", "6");
+  EXPECT_EQ(cache->ObjectEncoding("int"), Encoding::kRaw);
+  EXPECT_EQ(cache->Get("int").value(), "123456");
+
+  delete cache;
+}
+
+TEST(TestString, IncrBy) {
+  auto cache = Cache::New();
+
+  EXPECT_EQ(cache->IncrBy("counter", 9998), 9998);
+  cache->PExpire("counter", 1000);
+  EXPECT_EQ(cache->Incr("counter"), 9999);
+  EXPECT_EQ(cache->Incr("counter"), 10000);
+  EXPECT_EQ(cache->Get("counter").value(), "10000");
+  EXPECT_GT(cache->Pttl("counter"), 0);
+  EXPECT_EQ(cache->DecrBy("counter", 10001), -1);
+  EXPECT_EQ(cache->Get("counter").value(), "-1");
+
+  cache->Set("flag", "1");
+  EXPECT_EQ(cache->ObjectEncoding("flag"), Encoding::kInt);
+  cache->Append("flag", "0");
+  EXPECT_EQ(cache->Get("flag").value(), "10");
+
+  auto status = Status::OK();
+  cache->Set("max", std::to_string(INT64_MAX));
+  cache->Incr(status, "max");
+  EXPECT_EQ(status.code(), kInvalidInt64);
+  cache->Set("padded", "007");
+  cache->Incr(status, "padded");
+  EXPECT_EQ(status.code(), kInvalidInt64);
+
+  delete cache;
+}
+
+TEST(TestString, StringViewKey) {
+  auto cache = Cache::New();
+
+  const char buf[] = "key1key2";
+  std::string_view key1(buf, 4);
+  std::string_view key2(buf + 4, 4);
+  cache->Set(key1, "value1");
+  cache->Set(key2, "value2");
+  EXPECT_EQ(cache->Get("key1").value(), "value1");
+  EXPECT_EQ(cache->Get(key2).value(), "value2");
+  EXPECT_EQ(cache->Incr(std::string_view("counter")), 1);
+
+  delete cache;
+}
+
+TEST(TestString, GetRef) {
+  auto cache = Cache::New();
+
+  EXPECT_EQ(cache->GetRef("key"), nullptr);
+
+  std::string value(4096, 'a');
+  cache->Set("key", value);
+  auto ref = cache->GetRef("key");
+  ASSERT_NE(ref, nullptr);
+  EXPECT_EQ(*ref, value);
+  EXPECT_EQ(cache->GetRef("key"), ref);
+
+  cache->Append("key", "b");
+  EXPECT_EQ(*ref, value);
+  EXPECT_EQ(*cache->GetRef("key"), value + "b");
+
+  cache->Set("key", "short");
+  EXPECT_EQ(*ref, value);
+  EXPECT_EQ(*cache->GetRef("key"), "short");
+  cache->Set("int", "42");
+  EXPECT_EQ(*cache->GetRef("int"), "42");
+
+  delete cache;
+}
+
+TEST(TestString, MoveValue) {
+  auto cache = Cache::New();
+
+  std::string value(4096, 'a');
+  auto data = value.data();
+  cache->Set("key", std::move(value));
+  EXPECT_EQ(cache->GetRef("key")->data(), data);
+
+  std::string suffix(4096, 'b');
+  data = suffix.data();
+  EXPECT_EQ(cache->Append("new", std::move(suffix)), 4096);
+  EXPECT_EQ(cache->GetRef("new")->data(), data);
+  EXPECT_EQ(cache->Append("new", std::string("c")), 4097);
+
+  auto status = Status::OK();
+  cache->Set(status, "key", "value", NX | XX);
+  EXPECT_EQ(status.code(), kSyntaxError);
+
+  delete cache;
+}
+
+TEST(TestString, MGet) {
+  // 定时器不会在测试期间主动删除到期的键。
+  Options options;
+  options.timer_interval = 60 * 1000;
+  auto cache = Cache::New(options);
+
+  vector<string> keys;
+  for (int i = 0; i < 100; i++) {
+    keys.push_back("key" + to_string(i));
+    if (i % 3 == 0) {
+      cache->Set(keys.back(), to_string(i));
+    }
+  }
+  cache->Set("key1", "1", 0, PX(1));
+  keys.push_back("key0");
+  sleep_for(milliseconds(10));
+
+  auto values = cache->MGet(keys);
+  ASSERT_EQ(values.size(), keys.size());
+  for (int i = 0; i < 100; i++) {
+    if (i % 3 == 0) {
+      EXPECT_EQ(values[i].value(), to_string(i));
+    } else {
+      EXPECT_FALSE(values[i].has_value());
+    }
+  }
+  EXPECT_EQ(values.back().value(), "0");
+  // MGet 遇到的已过期的键立即删除。
+  EXPECT_EQ(cache->ExpireStats().lazy_expired_keys, 1);
+  EXPECT_EQ(cache->ExpireStats().volatile_keys, 0);
+
+  auto status = Status::OK();
+  values = cache->MGet(status, 16, keys);
+  EXPECT_EQ(status.code(), kDBIndexOutOfRange);
+  EXPECT_TRUE(values.empty());
+
+  delete cache;
+}
+
+TEST(TestString, MSet) {
+  auto cache = Cache::New();
+
+  cache->Set("a", "old", 0, EX(100));
+  cache->MSet({{"a", "1"}, {"b", "2"}, {"a", "3"}});
+  EXPECT_EQ(cache->Get("a").value(), "3");
+  EXPECT_EQ(cache->Get("b").value(), "2");
+  // 和 SET 一样清除原有的过期时间。
+  EXPECT_EQ(cache->Pttl("a"), -1);
+
+  vector<pair<string, string>> kvs = {{"c", "3"}, {"b", "4"}};
+  EXPECT_EQ(cache->MSetNX(kvs), 0);
+  EXPECT_FALSE(cache->Get("c").has_value());
+  EXPECT_EQ(cache->Get("b").value(), "2");
+
+  kvs = {{"c", "3"}, {"d", "4"}};
+  EXPECT_EQ(cache->MSetNX(kvs), 1);
+  EXPECT_EQ(cache->Get("c").value(), "3");
+  EXPECT_EQ(cache->Get("d").value(), "4");
+
+  delete cache;
+}
+
 TEST(TestString, Set) {
   auto cache = Cache::New();
 
@@ -147,4 +334,65 @@ TEST(TestString, SetWithPX) {
   delete cache;
 }
 
+TEST(TestString, Update) {
+  auto cache = Cache::New();
+
+  auto append = [](std::string& value, bool exists) {
+    value += exists ? "+" : "new";
+    return true;
+  };
+  EXPECT_EQ(cache->Update("key", append), 1);
+  EXPECT_EQ(cache->Get("key").value(), "new");
+  EXPECT_EQ(cache->Update("key", append, PX(100000)), 1);
+  EXPECT_EQ(cache->Get("key").value(), "new+");
+  EXPECT_GT(cache->Pttl("key"), 0);
+
+  // 返回 false 时不写回。
+  auto ignore = [](std::string&, bool) { return false; };
+  EXPECT_EQ(cache->Update("key", ignore), 0);
+  EXPECT_EQ(cache->Get("key").value(), "new+");
+  EXPECT_EQ(cache->Update("missing", ignore), 0);
+  EXPECT_FALSE(cache->Get("missing").has_value());
+
+  // 写回时重新选择编码，原有的过期时间保留。
+  cache->Set("counter", "41", 0, PX(100000));
+  EXPECT_EQ(cache->Update("counter",
+                          [](std::string& value, bool) {
+                            value = to_string(std::stoll(value) + 1);
+                            return true;
+                          }),
+            1);
+  EXPECT_EQ(cache->ObjectEncoding("counter"), Encoding::kInt);
+  EXPECT_EQ(cache->Incr("counter"), 43);
+  EXPECT_GT(cache->Pttl("counter"), 0);
+
+  // kRaw 原地修改，已经取出的句柄不受影响。
+  string large(100, 'x');
+  cache->Set("raw", large);
+  auto ref = cache->GetRef("raw");
+  EXPECT_EQ(cache->Update("raw", append), 1);
+  EXPECT_EQ(*ref, large);
+  EXPECT_EQ(cache->Get("raw").value(), large + "+");
+  EXPECT_EQ(cache->ObjectEncoding("raw"), Encoding::kRaw);
+
+  // kRaw 的值返回 false 表示没有修改，不更新版本号，不影响 Watch。
+  Batch batch;
+  cache->Watch(batch, {"raw"});
+  batch.Get("raw");
+  auto inspect = [&large](std::string& value, bool) {
+    EXPECT_EQ(value, large + "+");
+    return false;
+  };
+  EXPECT_EQ(cache->Update("raw", inspect), 0);
+  EXPECT_EQ(cache->Get("raw").value(), large + "+");
+  EXPECT_TRUE(cache->Exec(batch).has_value());
+
+  // 返回 true 时 Watch 的批次不再执行。
+  cache->Watch(batch, {"raw"});
+  EXPECT_EQ(cache->Update("raw", append), 1);
+  EXPECT_FALSE(cache->Exec(batch).has_value());
+
+  delete cache;
+}
+
 }  // namespace libcache
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <libcache/libcache.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+
+namespace libcache {
+
+TEST(TestTransaction, Exec) {
+  auto cache = Cache::New();
+  cache->Set("counter", "10");
+  cache->Set("name", "cache");
+
+  Batch batch;
+  batch.Get("counter")
+      .IncrBy("counter", 5)
+      .DecrBy("counter", 1)
+      .Append("name", "!")
+      .IncrBy("name", 1)
+      .PExpire("name", 100000)
+      .Pttl("name")
+      .Persist("name")
+      .Pttl("name")
+      .Set("other", "value", 0, PX(100000))
+      .Del("counter")
+      .Get("counter");
+  EXPECT_EQ(batch.size(), 12);
+
+  auto results = cache->Exec(batch);
+  ASSERT_TRUE(results.has_value());
+  ASSERT_EQ(results->size(), batch.size());
+  EXPECT_EQ((*results)[0].str.value(), "10");
+  EXPECT_EQ((*results)[1].integer, 15);
+  EXPECT_EQ((*results)[2].integer, 14);
+  EXPECT_EQ((*results)[3].integer, 6);
+  // 出错的命令不影响后面的命令。
+  EXPECT_EQ((*results)[4].status.code(), kInvalidInt64);
+  EXPECT_EQ((*results)[5].integer, 1);
+  EXPECT_GT((*results)[6].integer, 0);
+  EXPECT_EQ((*results)[7].integer, 1);
+  EXPECT_EQ((*results)[8].integer, -1);
+  EXPECT_EQ((*results)[9].str.value(), "OK");
+  EXPECT_EQ((*results)[10].integer, 1);
+  EXPECT_FALSE((*results)[11].str.has_value());
+
+  EXPECT_EQ(cache->Get("name").value(), "cache!");
+  EXPECT_GT(cache->Pttl("other"), 0);
+
+  delete cache;
+}
+
+TEST(TestTransaction, Watch) {
+  auto cache = Cache::New();
+  cache->Set("key", "1");
+
+  Batch batch;
+  cache->Watch(batch, {"key", "missing"});
+  batch.IncrBy("key", 1);
+  auto results = cache->Exec(batch);
+  ASSERT_TRUE(results.has_value());
+  EXPECT_EQ((*results)[0].integer, 2);
+
+  // 监视之后键被修改，Exec 不执行。
+  batch.Clear();
+  cache->Watch(batch, {"key"});
+  cache->Set("key", "10");
+  batch.IncrBy("key", 1);
+  EXPECT_FALSE(cache->Exec(batch).has_value());
+  EXPECT_EQ(cache->Get("key").value(), "10");
+
+  // 原地修改和删除也会使版本变化。
+  batch.Clear();
+  cache->Watch(batch, {"key"});
+  cache->Incr("key");
+  EXPECT_FALSE(cache->Exec(batch).has_value());
+  batch.Clear();
+  cache->Watch(batch, {"key"});
+  cache->Del({"key"});
+  EXPECT_FALSE(cache->Exec(batch).has_value());
+  batch.Clear();
+  cache->Watch(batch, {"missing"});
+  cache->FlushDB();
+  EXPECT_FALSE(cache->Exec(batch).has_value());
+
+  // 只读命令不改变版本。
+  batch.Clear();
+  cache->Set("key", "1");
+  cache->Watch(batch, {"key"});
+  cache->Get("key");
+  cache->Touch({"key"});
+  EXPECT_TRUE(cache->Exec(batch).has_value());
+
+  delete cache;
+}
+
+// 多个线程用 Watch/Exec 重试的方式对同一个计数器加一，不会丢失更新。
+TEST(TestTransaction, OptimisticIncrement) {
+  auto cache = Cache::New();
+  cache->Set("counter", "0");
+
+  constexpr int kThreads = 4;
+  constexpr int kIncrements = 1000;
+  vector<thread> threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.emplace_back([cache] {
+      for (int j = 0; j < kIncrements; j++) {
+        while (true) {
+          Batch batch;
+          cache->Watch(batch, {"counter"});
+          auto value = std::stoll(cache->Get("counter").value());
+          batch.Set("counter", to_string(value + 1));
+          if (cache->Exec(batch)) {
+            break;
+          }
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(cache->Get("counter").value(), to_string(kThreads * kIncrements));
+
+  delete cache;
+}
+
+}  // namespace libcache
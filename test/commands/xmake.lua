@@ -5,3 +5,19 @@ target("test-commands-string")
     add_files("string_test.cpp")
     add_deps("libcache")
     add_packages("gtest")
+
+target("test-commands-generic")
+    set_kind("binary")
+    set_group("test")
+    add_includedirs("$(projectdir)/include")
+    add_files("generic_test.cpp")
+    add_deps("libcache")
+    add_packages("gtest")
+
+target("test-commands-transaction")
+    set_kind("binary")
+    set_group("test")
+    add_includedirs("$(projectdir)/include")
+    add_files("transaction_test.cpp")
+    add_deps("libcache")
+    add_packages("gtest")
@@ -0,0 +1,121 @@
+#include "db/hash_table.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+using std::string;
+using std::string_view;
+using std::to_string;
+using std::unordered_set;
+
+namespace libcache::db {
+
+struct StringKey {
+  string_view operator()(const string& str) const { return str; }
+};
+
+using StringTable = HashTable<string, StringKey>;
+
+TEST(TestHashTable, InsertFindErase) {
+  StringTable table;
+  EXPECT_EQ(table.Find("key", HashKey("key")), nullptr);
+
+  for (int i = 0; i < 1000; i++) {
+    auto key = "key" + to_string(i);
+    table.Insert(key, HashKey(key));
+  }
+  EXPECT_EQ(table.size(), 1000);
+
+  for (int i = 0; i < 1000; i++) {
+    auto key = "key" + to_string(i);
+    auto value = table.Find(key, HashKey(key));
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, key);
+  }
+
+  for (int i = 0; i < 1000; i += 2) {
+    auto key = "key" + to_string(i);
+    EXPECT_TRUE(table.Erase(key, HashKey(key)));
+    EXPECT_FALSE(table.Erase(key, HashKey(key)));
+  }
+  EXPECT_EQ(table.size(), 500);
+
+  for (int i = 0; i < 1000; i++) {
+    auto key = "key" + to_string(i);
+    EXPECT_EQ(table.Find(key, HashKey(key)) != nullptr, i % 2 == 1);
+  }
+}
+
+TEST(TestHashTable, Reserve) {
+  StringTable table(1000, 0.5);
+  auto capacity = table.capacity();
+  EXPECT_GE(capacity, 2000);
+
+  for (int i = 0; i < 1000; i++) {
+    auto key = "key" + to_string(i);
+    table.Insert(key, HashKey(key));
+  }
+  EXPECT_EQ(table.capacity(), capacity);
+}
+
+TEST(TestHashTable, IncrementalRehash) {
+  StringTable table;
+  size_t rehash_count = 0;
+  for (int i = 0; i < 10000; i++) {
+    auto key = "key" + to_string(i);
+    table.Insert(key, HashKey(key));
+    if (table.rehashing()) {
+      rehash_count++;
+    }
+    if (table.rehashing() && i % 100 == 0) {
+      for (int j = 0; j <= i; j++) {
+        auto key = "key" + to_string(j);
+        ASSERT_NE(table.Find(key, HashKey(key)), nullptr);
+      }
+    }
+  }
+  EXPECT_GT(rehash_count, 0);
+
+  while (table.RehashStep(1)) {
+  }
+  EXPECT_FALSE(table.rehashing());
+  EXPECT_EQ(table.size(), 10000);
+  for (int i = 0; i < 10000; i++) {
+    auto key = "key" + to_string(i);
+    EXPECT_NE(table.Find(key, HashKey(key)), nullptr);
+  }
+}
+
+TEST(TestHashTable, RandomOperations) {
+  StringTable table;
+  unordered_set<string> expected;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, 5000);
+
+  for (int i = 0; i < 100000; i++) {
+    auto key = to_string(dist(gen));
+    auto hash = HashKey(key);
+    if (expected.count(key)) {
+      EXPECT_TRUE(table.Erase(key, hash));
+      expected.erase(key);
+    } else {
+      EXPECT_EQ(table.Find(key, hash), nullptr);
+      table.Insert(key, hash);
+      expected.insert(key);
+    }
+  }
+
+  EXPECT_EQ(table.size(), expected.size());
+  size_t count = 0;
+  table.ForEach([&](const string& key) {
+    EXPECT_TRUE(expected.count(key));
+    count++;
+  });
+  EXPECT_EQ(count, expected.size());
+}
+
+}  // namespace libcache::db
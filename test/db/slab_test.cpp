@@ -0,0 +1,102 @@
+#include "db/slab.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using std::mt19937;
+using std::pair;
+using std::vector;
+
+namespace libcache::db {
+
+static MemoryStats Stats(const SlabAllocator& allocator) {
+  MemoryStats stats;
+  allocator.AddStats(stats);
+  return stats;
+}
+
+TEST(TestSlab, AllocateFree) {
+  SlabAllocator allocator(false);
+
+  vector<void*> ptrs;
+  for (size_t size = 16; size <= SlabAllocator::kMaxSize; size += 16) {
+    auto ptr = allocator.Allocate(size);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 16, 0);
+    memset(ptr, 0xff, size);
+    ptrs.push_back(ptr);
+  }
+
+  auto stats = Stats(allocator);
+  EXPECT_EQ(stats.regions, 1);
+  EXPECT_EQ(stats.slabs, SlabAllocator::kClassCount);
+  EXPECT_EQ(stats.slab_classes.size(), SlabAllocator::kClassCount);
+  size_t used_blocks = 0;
+  for (const auto& class_stats : stats.slab_classes) {
+    EXPECT_LE(class_stats.used_blocks, class_stats.total_blocks);
+    used_blocks += class_stats.used_blocks;
+  }
+  EXPECT_EQ(used_blocks, SlabAllocator::kMaxSize / 16);
+
+  for (auto ptr : ptrs) {
+    SlabAllocator::Free(ptr);
+  }
+  stats = Stats(allocator);
+  EXPECT_EQ(stats.used_bytes, 0);
+  EXPECT_EQ(stats.free_slabs, SlabAllocator::kClassCount);
+
+  allocator.ReleaseIfEmpty();
+  EXPECT_EQ(Stats(allocator).regions, 0);
+}
+
+TEST(TestSlab, ReuseFreedBlocks) {
+  SlabAllocator allocator(false);
+
+  auto ptr = allocator.Allocate(40);
+  SlabAllocator::Free(ptr);
+  EXPECT_EQ(allocator.Allocate(48), ptr);
+  SlabAllocator::Free(ptr);
+}
+
+TEST(TestSlab, RandomOperations) {
+  SlabAllocator allocator(true);
+  mt19937 rand(0);
+
+  vector<pair<unsigned char*, size_t>> blocks;
+  for (int i = 0; i < 200000; i++) {
+    if (blocks.empty() || rand() % 3 != 0) {
+      size_t size = rand() % SlabAllocator::kMaxSize + 1;
+      auto ptr = static_cast<unsigned char*>(allocator.Allocate(size));
+      memset(ptr, size & 0xff, size);
+      blocks.emplace_back(ptr, size);
+      continue;
+    }
+
+    auto index = rand() % blocks.size();
+    auto [ptr, size] = blocks[index];
+    for (size_t j = 0; j < size; j++) {
+      ASSERT_EQ(ptr[j], size & 0xff);
+    }
+    SlabAllocator::Free(ptr);
+    blocks[index] = blocks.back();
+    blocks.pop_back();
+  }
+
+  auto stats = Stats(allocator);
+  size_t used_bytes = 0;
+  for (const auto& class_stats : stats.slab_classes) {
+    used_bytes += class_stats.used_blocks * class_stats.block_size;
+  }
+  EXPECT_EQ(used_bytes, stats.used_bytes);
+  EXPECT_EQ(stats.slab_classes[SlabAllocator::kClassCount - 1].block_size,
+            SlabAllocator::kMaxSize);
+
+  for (auto [ptr, size] : blocks) {
+    SlabAllocator::Free(ptr);
+  }
+  EXPECT_EQ(Stats(allocator).used_bytes, 0);
+}
+
+}  // namespace libcache::db
@@ -0,0 +1,14 @@
+target("test-db-hash-table")
+    set_kind("binary")
+    set_group("test")
+    add_includedirs("$(projectdir)/src")
+    add_files("hash_table_test.cpp")
+    add_packages("gtest")
+
+target("test-db-slab")
+    set_kind("binary")
+    set_group("test")
+    add_includedirs("$(projectdir)/include", "$(projectdir)/src")
+    add_files("slab_test.cpp")
+    add_deps("libcache")
+    add_packages("gtest")
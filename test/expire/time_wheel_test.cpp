@@ -0,0 +1,173 @@
+#include "expire/time_wheel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using std::mt19937_64;
+using std::vector;
+
+namespace libcache::expire {
+
+struct FakeClock {
+  static int64_t Now() { return now; }
+  static inline int64_t now = 0;
+};
+
+struct Timer {
+  int64_t expire() const { return at; }
+  TimerHandle& timer_handle() { return handle; }
+
+  int64_t at = 0;
+  TimerHandle handle;
+  int64_t expired_at = -1;
+};
+
+using Wheel = TimeWheel<FakeClock, Timer*>;
+
+static void Advance(Wheel& wheel, int64_t to) {
+  FakeClock::now = to;
+  wheel.Tick([](Timer* timer) { timer->expired_at = FakeClock::now; });
+}
+
+TEST(TestTimeWheel, ExpireInOrder) {
+  FakeClock::now = 1000;
+  Wheel wheel(4, 10);
+
+  mt19937_64 rng(1);
+  vector<Timer> timers(10000);
+  for (auto& timer : timers) {
+    timer.at = 1000 + rng() % 200000;
+  }
+  // 超出各层范围的元素和已经到期的元素。
+  timers[0].at = INT64_MAX / 2;
+  timers[1].at = 900;
+  for (auto& timer : timers) {
+    wheel.Add(&timer);
+  }
+  EXPECT_EQ(wheel.size(), timers.size());
+
+  for (int64_t now = 1000; now <= 202000; now += 7) {
+    Advance(wheel, now);
+  }
+  for (const auto& timer : timers) {
+    if (timer.at == INT64_MAX / 2) {
+      EXPECT_EQ(timer.expired_at, -1);
+      continue;
+    }
+    // 不会提前到期，最多晚一个刻度加上推进的步长。
+    EXPECT_GE(timer.expired_at, timer.at);
+    EXPECT_LT(timer.expired_at, std::max<int64_t>(timer.at, 1000) + 10 + 7);
+  }
+  EXPECT_EQ(wheel.size(), 1);
+}
+
+TEST(TestTimeWheel, Remove) {
+  FakeClock::now = 0;
+  Wheel wheel(64, 1);
+
+  vector<Timer> timers(1000);
+  for (size_t i = 0; i < timers.size(); i++) {
+    timers[i].at = i * 100;
+    wheel.Add(&timers[i]);
+  }
+  for (size_t i = 0; i < timers.size(); i += 2) {
+    wheel.Remove(&timers[i]);
+  }
+  EXPECT_EQ(wheel.size(), 500);
+
+  Advance(wheel, 1000000);
+  for (size_t i = 0; i < timers.size(); i++) {
+    EXPECT_EQ(timers[i].expired_at, i % 2 ? 1000000 : -1);
+  }
+  EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(TestTimeWheel, Front) {
+  FakeClock::now = 1000;
+  Wheel wheel(64, 1);
+  EXPECT_EQ(wheel.Front(), nullptr);
+
+  mt19937_64 rng(1);
+  vector<Timer> timers(10000);
+  for (auto& timer : timers) {
+    timer.at = 1001 + rng() % 4000;
+    wheel.Add(&timer);
+  }
+  // 已经到期的元素排在最前。
+  Timer due;
+  due.at = 900;
+  wheel.Add(&due);
+  EXPECT_EQ(wheel.Front(), &due);
+  wheel.Remove(&due);
+
+  // 同时加入的元素按 64 个刻度的槽有序。
+  int64_t last = 0;
+  for (size_t i = 0; i < timers.size() / 2; i++) {
+    auto timer = wheel.Front();
+    ASSERT_NE(timer, nullptr);
+    EXPECT_GE(timer->at / 64, last / 64);
+    last = timer->at;
+    wheel.Remove(timer);
+  }
+
+  // 推进后从头查找，到期的元素先处理掉。
+  Advance(wheel, 3000);
+  last = 0;
+  while (auto timer = wheel.Front()) {
+    EXPECT_GT(timer->at, 3000);
+    EXPECT_GE(timer->at / 64, last / 64);
+    last = timer->at;
+    wheel.Remove(timer);
+  }
+  EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(TestTimeWheel, FrontAcrossLevels) {
+  FakeClock::now = 1000;
+  Wheel wheel(64, 1);
+
+  // 距离 70 个刻度，放在第 1 层 [1024, 1088) 的槽中。
+  Timer upper;
+  upper.at = 1070;
+  wheel.Add(&upper);
+  Advance(wheel, 1020);
+
+  // 都在第 0 层，1083 的槽绕过了 1024 的边界。
+  Timer near;
+  near.at = 1030;
+  Timer wrapped;
+  wrapped.at = 1083;
+  wheel.Add(&wrapped);
+  wheel.Add(&near);
+
+  // 第 0 层内按刻度排序，整个第 0 层排在第 1 层之前，所以 1083 先于 1070。
+  vector<Timer*> order;
+  while (auto timer = wheel.Front()) {
+    order.push_back(timer);
+    wheel.Remove(timer);
+  }
+  EXPECT_EQ(order, (vector<Timer*>{&near, &wrapped, &upper}));
+}
+
+TEST(TestTimeWheel, Clear) {
+  FakeClock::now = 0;
+  Wheel wheel(64, 1);
+
+  vector<Timer> timers(100);
+  for (size_t i = 0; i < timers.size(); i++) {
+    timers[i].at = i;
+    wheel.Add(&timers[i]);
+  }
+  wheel.Clear();
+  EXPECT_EQ(wheel.size(), 0);
+
+  Advance(wheel, 1000);
+  for (const auto& timer : timers) {
+    EXPECT_EQ(timer.expired_at, -1);
+  }
+}
+
+}  // namespace libcache::expire
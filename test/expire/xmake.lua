@@ -0,0 +1,6 @@
+target("test-expire-time-wheel")
+    set_kind("binary")
+    set_group("test")
+    add_includedirs("$(projectdir)/src")
+    add_files("time_wheel_test.cpp")
+    add_packages("gtest")
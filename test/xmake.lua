@@ -1,2 +1,4 @@
 add_requires("gtest >= 1.12.1")
 includes("commands")
+includes("db")
+includes("expire")
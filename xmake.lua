@@ -14,3 +14,4 @@ target("libcache")
     add_packages("crc32c", "protobuf-cpp")
 
 includes("test")
+includes("bench")